@@ -1,16 +1,45 @@
 #pragma once
 
+#include <cstdint>
+#include <iosfwd>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "SmallVector.h"
+
+// Unsigned types that can hold values above INT64_MAX. The int64_t
+// overloads would wrap them, so they take the exact BigInteger path.
+template <typename Integer>
+using EnableIfWideUnsigned =
+    std::enable_if_t<std::is_unsigned_v<Integer> &&
+                         sizeof(Integer) >= sizeof(int64_t),
+                     int>;
+
+template <size_t Limbs>
+class FixedBigInteger;
+template <size_t Bits, bool Signed>
+class WideInt;
+
 class BigInteger {
   public:
     BigInteger();
-    BigInteger(int);
+    template <typename Integer,
+              typename = std::enable_if_t<std::is_integral_v<Integer>>>
+    BigInteger(Integer);
     BigInteger(const std::string&);
     explicit BigInteger(const char*);
 
-    BigInteger operator-() const;
+    BigInteger(const BigInteger&) = default;
+    BigInteger(BigInteger&&) noexcept;
+    BigInteger& operator=(const BigInteger&) = default;
+    BigInteger& operator=(BigInteger&&) noexcept;
+
+    BigInteger operator-() const&;
+    BigInteger operator-() &&;
 
     BigInteger& operator+=(const BigInteger&);
     BigInteger& operator-=(const BigInteger&);
@@ -18,49 +47,303 @@ class BigInteger {
     BigInteger& operator/=(const BigInteger&);
     BigInteger& operator%=(const BigInteger&);
 
+    // Machine integer operands are handled in one pass over the limbs.
+    BigInteger& operator+=(int64_t);
+    BigInteger& operator-=(int64_t);
+    BigInteger& operator*=(int64_t);
+    BigInteger& operator/=(int64_t);
+    BigInteger& operator%=(int64_t);
+    template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+    BigInteger& operator+=(Integer);
+    template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+    BigInteger& operator-=(Integer);
+    template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+    BigInteger& operator*=(Integer);
+    template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+    BigInteger& operator/=(Integer);
+    template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+    BigInteger& operator%=(Integer);
+
     BigInteger& operator++();
     BigInteger operator++(int);
     BigInteger& operator--();
     BigInteger operator--(int);
 
     std::string toString() const;
+    size_t limbCount() const;
+    size_t bitLength() const;
+    // Low 64 bits of the two's complement value.
+    int64_t toInt64() const;
+
+    static BigInteger powerOfTwo(size_t);
+    static BigInteger powerOfTen(size_t);
+
+    // Every number in the text, in order: each maximal run of digits,
+    // negative when directly preceded by '-'. Other characters only
+    // separate numbers.
+    static std::vector<BigInteger> parseAll(std::string_view);
+    // parseAll over a file mapped into memory.
+    static std::vector<BigInteger> parseFile(const std::string&);
+
+    // Binary encoding: a 16-byte header (magic "BI", format version, limb
+    // format, sign), the limb count as a 64-bit integer and the limbs, all
+    // little-endian. Limbs are written in this build's base and read in
+    // either one.
+    void serialize(std::ostream&) const;
+    static BigInteger deserialize(std::istream&);
+
+    static BigInteger multiplyNTT(const BigInteger&, const BigInteger&);
+
+    // Products of numbers with kParallelThreshold_ limbs or more spread
+    // their independent subproducts over up to this many threads in total.
+    // Results do not depend on the setting, which defaults to 1.
+    static void setThreadCount(size_t);
+    static size_t threadCount();
+
+    // base^exp mod mod for exp >= 0 and mod > 0, in [0, mod).
+    static BigInteger powMod(const BigInteger&, const BigInteger&,
+                             const BigInteger&);
+
+    // Modular contexts, available after including BigIntegerModular.h.
+    class Montgomery;
+    class Divisor;
+
+    // Summation with deferred carries, available after including
+    // BigIntegerAccumulator.h.
+    class Accumulator;
+
+    // Read-only access to a serialized number in memory, available after
+    // including BigIntegerView.h.
+    class View;
+
+    // Lazy expressions, available after including BigIntegerExpr.h.
+    template <typename Node>
+    class Expr;
+    template <typename Value>
+    class ExprLeaf;
+    class ExprScalar;
+    template <typename Left, typename Right, bool kSubtract>
+    class ExprSum;
+    template <typename Left, typename Right>
+    class ExprProduct;
+    template <typename Node>
+    class ExprNegation;
+
+    static Expr<ExprLeaf<const BigInteger&>> expr(const BigInteger&);
+
+    template <typename Node>
+    BigInteger(const Expr<Node>&);
+    template <typename Node>
+    BigInteger& operator=(const Expr<Node>&);
+    template <typename Node>
+    BigInteger& operator+=(const Expr<Node>&);
+    template <typename Node>
+    BigInteger& operator-=(const Expr<Node>&);
 
     explicit operator bool() const;
 
     friend bool operator<(const BigInteger&, const BigInteger&);
     friend std::ostream& operator<<(std::ostream&, const BigInteger&);
     friend std::istream& operator>>(std::istream&, BigInteger&);
+    friend std::pair<BigInteger, BigInteger> divmod(const BigInteger&,
+                                                    const BigInteger&);
+    friend std::pair<BigInteger, int64_t> divmod(const BigInteger&, int64_t);
+    friend bool operator<(const BigInteger&, int64_t);
+    friend bool operator<(int64_t, const BigInteger&);
+    friend bool operator==(const BigInteger&, int64_t);
+    friend BigInteger gcd(const BigInteger&, const BigInteger&);
+    friend std::tuple<BigInteger, BigInteger, BigInteger> extendedGcd(
+        const BigInteger&, const BigInteger&);
+    friend BigInteger iroot(const BigInteger&, size_t);
+    friend bool isPerfectPower(const BigInteger&);
+    friend BigInteger operator+(BigInteger&&, BigInteger&&);
+    friend BigInteger operator-(BigInteger&&, BigInteger&&);
+    friend BigInteger operator*(const BigInteger&, const BigInteger&);
+    template <size_t Limbs>
+    friend class FixedBigInteger;
+    template <char... Digits>
+    friend BigInteger operator"" _bi();
+    template <size_t Bits, bool Signed>
+    friend class WideInt;
 
   private:
-    static const long long kBIBase_ = 1'000'000'000;
-    static const size_t kBIBaseSize_ = 9;
+#ifdef BIGINTEGER_BINARY_LIMBS
+    using Limb = uint64_t;
+    using DoubleLimb = unsigned __int128;
+    static constexpr DoubleLimb kBIBase_ = DoubleLimb(1) << 64;
+    static constexpr Limb kDecimalBase_ = 10'000'000'000'000'000'000ULL;
+    static constexpr size_t kBIBaseSize_ = 19;
+    static constexpr size_t kNTTThreshold_ = 250000;
+    static constexpr size_t kInlineLimbs_ = 3;
+    static constexpr size_t kLimbBits_ = 64;
+#else
+    using Limb = uint32_t;
+    using DoubleLimb = uint64_t;
+    static constexpr DoubleLimb kBIBase_ = 1'000'000'000;
+    static constexpr Limb kDecimalBase_ = 1'000'000'000;
+    static constexpr size_t kBIBaseSize_ = 9;
+    static constexpr size_t kNTTThreshold_ = 12000;
+    static constexpr size_t kInlineLimbs_ = 6;
+    static constexpr size_t kLimbBits_ = 29;
+#endif
+    using LimbVector = SmallVector<Limb, kInlineLimbs_>;
+
+    static constexpr size_t kKaratsubaThreshold_ = 40;
+    static constexpr size_t kToomThreshold_ = 300;
+    static constexpr size_t kReciprocalThreshold_ = 40;
+    static constexpr size_t kRadixThreshold_ = 30;
+    static constexpr size_t kBarrettThreshold_ = 40;
+    static constexpr size_t kParallelThreshold_ = 1000;
+    static constexpr size_t kVectorThreshold_ = 16;
 
-    std::vector<long long> digits_;
+    LimbVector digits_;
     bool is_negative_;
 
     void normalizeNum();
-    void reverseNum();
     size_t len() const;
-    BigInteger getSubNum(size_t, size_t) const;
 
     bool isZero() const;
     void absoluteSum(const BigInteger&);
     void absoluteSubtraction(const BigInteger&);
     int absoluteComparison(const BigInteger&) const;
 
-    static void addLeadingZeroes(std::string&, long long, bool);
-    static long long moduloBase(long long);
-    static size_t getNumeralLen(long long);
+    void assignInteger(uint64_t, bool);
+    void addSmall(Limb, bool);
+    int64_t divideByInteger(int64_t);
+    int compareWithInteger(int64_t) const;
+
+    static BigInteger fromLimbs(const Limb*, size_t);
+    void multiplyBySmall(Limb);
+    Limb divideBySmall(Limb);
+    void assignProduct(const BigInteger&, const BigInteger&);
+    void addProduct(const BigInteger&, const BigInteger&, bool, BigInteger&);
+    void addScaled(const BigInteger&, int64_t, bool, BigInteger&);
+    void shiftLimbsLeft(size_t);
+    void shiftLimbsRight(size_t);
+    static BigInteger reciprocal(const BigInteger&);
+    static BigInteger rootFloor(const BigInteger&, size_t);
+    static BigInteger rootEstimate(const BigInteger&, size_t);
+    static BigInteger rootUpperBound(const BigInteger&, size_t);
+    static bool lehmerCofactors(const BigInteger&, const BigInteger&,
+                                int64_t*);
+    static Limb binaryGcd(Limb, Limb);
+
+    struct RadixPower;
+    static const RadixPower& radixPower(size_t, bool);
+    LimbVector toDecimalChunks() const;
+    static void appendDecimalChunks(const BigInteger&, size_t,
+                                    LimbVector&);
+    static void peelDecimalChunks(BigInteger, LimbVector&);
+    static BigInteger fromDecimalChunks(const Limb*, size_t);
+    static BigInteger fromDigits(const char*, size_t, bool);
+    static size_t readDigits(std::streambuf*, bool, BigInteger&, bool&);
+    static BigInteger fromEncodedLimbs(const char*, size_t, uint8_t, bool);
+
+    static Limb addWithCarry(Limb, Limb, Limb&);
+    static Limb subtractWithLoan(Limb, Limb, Limb&);
+    static Limb multiplyAdd(Limb, Limb, Limb, Limb&);
+
+    static Limb addLimbs(Limb*, size_t, const Limb*, size_t);
+    static void subtractLimbs(Limb*, size_t, const Limb*, size_t);
+    static void subtractFromLimbs(Limb*, const Limb*, size_t);
+    // AVX2 versions of the add, subtract and compare loops, used for runs
+    // of at least kVectorThreshold_ limbs when the CPU supports them.
+    static bool hasVectorKernels();
+    static Limb addLimbsVector(Limb*, const Limb*, size_t, Limb);
+    static Limb subtractLimbsVector(Limb*, const Limb*, const Limb*, size_t,
+                                    Limb);
+    static int compareLimbsVector(const Limb*, const Limb*, size_t);
+    static void multiplyLimbs(const Limb*, size_t, const Limb*, size_t, Limb*);
+    static void multiplySchoolbook(const Limb*, size_t, const Limb*, size_t,
+                                   Limb*);
+    static void multiplyKaratsuba(const Limb*, size_t, const Limb*, size_t,
+                                  Limb*);
+    static void multiplyToom3(const Limb*, size_t, const Limb*, size_t, Limb*);
+    static void multiplyLimbsNTT(const Limb*, size_t, const Limb*, size_t,
+                                 Limb*);
+    static void divideLimbs(const Limb*, size_t, const Limb*, size_t, Limb*,
+                            Limb*);
+
+    template <typename... Tasks>
+    static void runTasks(size_t, Tasks&&...);
+    static bool reserveThread();
+    static void releaseThread();
+
+    static void addLeadingZeroes(std::string&, Limb, bool);
+    static size_t getNumeralLen(Limb);
 };
 
+template <typename Integer, typename>
+BigInteger::BigInteger(Integer num) : is_negative_(false) {
+    bool is_negative = false;
+    if constexpr (std::is_signed_v<Integer>) {
+        is_negative = num < 0;
+    }
+    uint64_t magnitude = static_cast<uint64_t>(num);
+    assignInteger(is_negative ? 0 - magnitude : magnitude, is_negative);
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer>>
+BigInteger& BigInteger::operator+=(Integer num) {
+    return *this += BigInteger(num);
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer>>
+BigInteger& BigInteger::operator-=(Integer num) {
+    return *this -= BigInteger(num);
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer>>
+BigInteger& BigInteger::operator*=(Integer num) {
+    return *this *= BigInteger(num);
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer>>
+BigInteger& BigInteger::operator/=(Integer num) {
+    return *this /= BigInteger(num);
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer>>
+BigInteger& BigInteger::operator%=(Integer num) {
+    return *this %= BigInteger(num);
+}
+
 BigInteger operator+(BigInteger, const BigInteger&);
+BigInteger operator+(const BigInteger&, BigInteger&&);
+BigInteger operator+(BigInteger&&, BigInteger&&);
 BigInteger operator-(BigInteger, const BigInteger&);
-BigInteger operator*(BigInteger, const BigInteger&);
+BigInteger operator-(const BigInteger&, BigInteger&&);
+BigInteger operator-(BigInteger&&, BigInteger&&);
+BigInteger operator*(const BigInteger&, const BigInteger&);
 BigInteger operator/(BigInteger, const BigInteger&);
 BigInteger operator%(BigInteger, const BigInteger&);
 
-BigInteger operator"" _bi(unsigned long long);
-BigInteger operator"" _bi(const char*);
+BigInteger operator+(BigInteger, int64_t);
+BigInteger operator+(int64_t, BigInteger);
+BigInteger operator-(BigInteger, int64_t);
+BigInteger operator-(int64_t, BigInteger);
+BigInteger operator*(BigInteger, int64_t);
+BigInteger operator*(int64_t, BigInteger);
+BigInteger operator/(BigInteger, int64_t);
+BigInteger operator%(BigInteger, int64_t);
+
+std::pair<BigInteger, BigInteger> divmod(const BigInteger&, const BigInteger&);
+std::pair<BigInteger, int64_t> divmod(const BigInteger&, int64_t);
+
+// Nonnegative greatest common divisor; gcd(0, 0) is 0.
+BigInteger gcd(const BigInteger&, const BigInteger&);
+// Returns {g, x, y} with num1 * x + num2 * y == g == gcd(num1, num2).
+std::tuple<BigInteger, BigInteger, BigInteger> extendedGcd(const BigInteger&,
+                                                           const BigInteger&);
+
+// floor(sqrt(num)) for num >= 0.
+BigInteger isqrt(const BigInteger&);
+// The k-th root of num rounded toward zero, for k > 0. Even roots need
+// num >= 0.
+BigInteger iroot(const BigInteger&, size_t);
+// Whether num == a^k for some integer a and some k >= 2, which holds for
+// 0, 1 and -1.
+bool isPerfectPower(const BigInteger&);
 
 bool operator<(const BigInteger&, const BigInteger&);
 bool operator>(const BigInteger&, const BigInteger&);
@@ -69,7 +352,128 @@ bool operator!=(const BigInteger&, const BigInteger&);
 bool operator>=(const BigInteger&, const BigInteger&);
 bool operator<=(const BigInteger&, const BigInteger&);
 
+bool operator<(const BigInteger&, int64_t);
+bool operator<(int64_t, const BigInteger&);
+bool operator>(const BigInteger&, int64_t);
+bool operator>(int64_t, const BigInteger&);
+bool operator==(const BigInteger&, int64_t);
+bool operator==(int64_t, const BigInteger&);
+bool operator!=(const BigInteger&, int64_t);
+bool operator!=(int64_t, const BigInteger&);
+bool operator>=(const BigInteger&, int64_t);
+bool operator>=(int64_t, const BigInteger&);
+bool operator<=(const BigInteger&, int64_t);
+bool operator<=(int64_t, const BigInteger&);
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+BigInteger operator+(BigInteger num1, Integer num2) {
+    return num1 + BigInteger(num2);
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+BigInteger operator+(Integer num1, BigInteger num2) {
+    return BigInteger(num1) + num2;
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+BigInteger operator-(BigInteger num1, Integer num2) {
+    return num1 - BigInteger(num2);
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+BigInteger operator-(Integer num1, BigInteger num2) {
+    return BigInteger(num1) - num2;
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+BigInteger operator*(BigInteger num1, Integer num2) {
+    return num1 * BigInteger(num2);
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+BigInteger operator*(Integer num1, BigInteger num2) {
+    return BigInteger(num1) * num2;
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+BigInteger operator/(BigInteger num1, Integer num2) {
+    return num1 / BigInteger(num2);
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+BigInteger operator%(BigInteger num1, Integer num2) {
+    return num1 % BigInteger(num2);
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+std::pair<BigInteger, BigInteger> divmod(const BigInteger& num1,
+                                         Integer num2) {
+    return divmod(num1, BigInteger(num2));
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+bool operator<(const BigInteger& num1, Integer num2) {
+    return num1 < BigInteger(num2);
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+bool operator<(Integer num1, const BigInteger& num2) {
+    return BigInteger(num1) < num2;
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+bool operator>(const BigInteger& num1, Integer num2) {
+    return num1 > BigInteger(num2);
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+bool operator>(Integer num1, const BigInteger& num2) {
+    return BigInteger(num1) > num2;
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+bool operator==(const BigInteger& num1, Integer num2) {
+    return num1 == BigInteger(num2);
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+bool operator==(Integer num1, const BigInteger& num2) {
+    return BigInteger(num1) == num2;
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+bool operator!=(const BigInteger& num1, Integer num2) {
+    return num1 != BigInteger(num2);
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+bool operator!=(Integer num1, const BigInteger& num2) {
+    return BigInteger(num1) != num2;
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+bool operator>=(const BigInteger& num1, Integer num2) {
+    return num1 >= BigInteger(num2);
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+bool operator>=(Integer num1, const BigInteger& num2) {
+    return BigInteger(num1) >= num2;
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+bool operator<=(const BigInteger& num1, Integer num2) {
+    return num1 <= BigInteger(num2);
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+bool operator<=(Integer num1, const BigInteger& num2) {
+    return BigInteger(num1) <= num2;
+}
+
 std::ostream& operator<<(std::ostream&, const BigInteger&);
 std::istream& operator>>(std::istream&, const BigInteger&);
 
-void setSign(BigInteger&, bool);
\ No newline at end of file
+void setSign(BigInteger&, bool);
+
+#include "FixedBigInteger.h"
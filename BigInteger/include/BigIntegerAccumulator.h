@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+
+#include "BigInteger.h"
+
+// Sums many BigIntegers without normalizing after every addition. Limbs
+// are added into double-width columns, and carries are propagated only
+// when the columns could overflow (every kCarryInterval_ additions) or
+// in finish. Positive and negative terms go to separate columns and are
+// subtracted once at the end.
+//
+// Accumulators filled independently, for example one per thread, can be
+// merged with += before calling finish.
+class BigInteger::Accumulator {
+  public:
+    Accumulator& operator+=(const BigInteger&);
+    Accumulator& operator-=(const BigInteger&);
+    Accumulator& operator+=(const Accumulator&);
+
+    // Returns the sum so far; the accumulator stays usable.
+    BigInteger finish();
+
+  private:
+    static constexpr size_t kCarryInterval_ = size_t(1) << 30;
+
+    std::vector<DoubleLimb> positive_;
+    std::vector<DoubleLimb> negative_;
+    // Every column is below pending_ * kBIBase_.
+    size_t pending_ = 1;
+
+    void reserve(size_t);
+    static void addColumns(std::vector<DoubleLimb>&, const Limb*, size_t);
+    static void addColumns(std::vector<DoubleLimb>&,
+                           const std::vector<DoubleLimb>&);
+    static void propagate(std::vector<DoubleLimb>&);
+    static BigInteger toNumber(const std::vector<DoubleLimb>&);
+};
@@ -0,0 +1,317 @@
+#pragma once
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include "BigInteger.h"
+
+// Opt-in lazy expressions over BigInteger. Wrapping an operand with
+// BigInteger::expr makes +, - and * build an expression tree instead of a
+// temporary per node:
+//
+//     result = BigInteger::expr(a) * b + BigInteger::expr(c) * d - e;
+//
+// The tree is evaluated when it is assigned, added or subtracted into a
+// BigInteger. Products are accumulated straight into the destination
+// with a fused multiply-add kernel, and the destination and the product
+// scratch are sized once from limb bounds of the whole tree. Machine
+// integer operands that fit in int64_t become scalars, and a product with
+// one is a single pass over the other factor; 64-bit unsigned ones become
+// BigInteger leaves, like in the BigInteger overloads. Operands that are
+// lvalues are held by reference, so an expression has to be evaluated
+// within the full-expression that builds it.
+
+template <typename Value>
+class BigInteger::ExprLeaf {
+  public:
+    template <typename T>
+    explicit ExprLeaf(T&& value) : value_(std::forward<T>(value)) {}
+
+    size_t limbBound() const { return value_.len(); }
+    size_t productBound() const { return 0; }
+    bool aliases(const BigInteger* num) const { return &value_ == num; }
+
+    void accumulate(BigInteger& result, bool subtract, BigInteger&) const {
+        if (subtract) {
+            result -= value_;
+        } else {
+            result += value_;
+        }
+    }
+
+    const BigInteger& value(BigInteger&, BigInteger&) const { return value_; }
+
+  private:
+    Value value_;
+};
+
+class BigInteger::ExprScalar {
+  public:
+    explicit ExprScalar(int64_t value) : value_(value) {}
+
+    size_t limbBound() const { return 64 / kLimbBits_ + 1; }
+    size_t productBound() const { return 0; }
+    bool aliases(const BigInteger*) const { return false; }
+    int64_t factor() const { return value_; }
+
+    void accumulate(BigInteger& result, bool subtract, BigInteger&) const {
+        if (subtract) {
+            result -= value_;
+        } else {
+            result += value_;
+        }
+    }
+
+    const BigInteger& value(BigInteger& storage, BigInteger&) const {
+        storage = value_;
+        return storage;
+    }
+
+  private:
+    int64_t value_;
+};
+
+template <typename Left, typename Right, bool kSubtract>
+class BigInteger::ExprSum {
+  public:
+    ExprSum(Left left, Right right)
+        : left_(std::move(left)), right_(std::move(right)) {}
+
+    size_t limbBound() const {
+        return std::max(left_.limbBound(), right_.limbBound()) + 1;
+    }
+    size_t productBound() const {
+        return std::max(left_.productBound(), right_.productBound());
+    }
+    bool aliases(const BigInteger* num) const {
+        return left_.aliases(num) || right_.aliases(num);
+    }
+
+    void accumulate(BigInteger& result, bool subtract,
+                    BigInteger& scratch) const {
+        left_.accumulate(result, subtract, scratch);
+        right_.accumulate(result, subtract != kSubtract, scratch);
+    }
+
+    const BigInteger& value(BigInteger& storage, BigInteger& scratch) const {
+        storage.digits_.reserve(limbBound());
+        accumulate(storage, false, scratch);
+        return storage;
+    }
+
+  private:
+    Left left_;
+    Right right_;
+};
+
+template <typename Left, typename Right>
+class BigInteger::ExprProduct {
+  public:
+    ExprProduct(Left left, Right right)
+        : left_(std::move(left)), right_(std::move(right)) {}
+
+    size_t limbBound() const {
+        return left_.limbBound() + right_.limbBound();
+    }
+    size_t productBound() const {
+        return std::max(
+            {limbBound(), left_.productBound(), right_.productBound()});
+    }
+    bool aliases(const BigInteger* num) const {
+        return left_.aliases(num) || right_.aliases(num);
+    }
+
+    void accumulate(BigInteger& result, bool subtract,
+                    BigInteger& scratch) const {
+        BigInteger left_storage;
+        BigInteger right_storage;
+        if constexpr (std::is_same_v<Right, ExprScalar>) {
+            result.addScaled(left_.value(left_storage, scratch),
+                             right_.factor(), subtract, scratch);
+        } else if constexpr (std::is_same_v<Left, ExprScalar>) {
+            result.addScaled(right_.value(right_storage, scratch),
+                             left_.factor(), subtract, scratch);
+        } else {
+            const BigInteger& left = left_.value(left_storage, scratch);
+            const BigInteger& right = right_.value(right_storage, scratch);
+            result.addProduct(left, right, subtract, scratch);
+        }
+    }
+
+    const BigInteger& value(BigInteger& storage, BigInteger& scratch) const {
+        storage.digits_.reserve(limbBound());
+        accumulate(storage, false, scratch);
+        return storage;
+    }
+
+  private:
+    Left left_;
+    Right right_;
+};
+
+template <typename Node>
+class BigInteger::ExprNegation {
+  public:
+    explicit ExprNegation(Node node) : node_(std::move(node)) {}
+
+    size_t limbBound() const { return node_.limbBound(); }
+    size_t productBound() const { return node_.productBound(); }
+    bool aliases(const BigInteger* num) const { return node_.aliases(num); }
+
+    void accumulate(BigInteger& result, bool subtract,
+                    BigInteger& scratch) const {
+        node_.accumulate(result, !subtract, scratch);
+    }
+
+    const BigInteger& value(BigInteger& storage, BigInteger& scratch) const {
+        storage.digits_.reserve(limbBound());
+        accumulate(storage, false, scratch);
+        return storage;
+    }
+
+  private:
+    Node node_;
+};
+
+template <typename Node>
+class BigInteger::Expr {
+  public:
+    explicit Expr(Node node) : node_(std::move(node)) {}
+
+    const Node& node() const& { return node_; }
+    Node&& node() && { return std::move(node_); }
+
+    bool aliases(const BigInteger* num) const { return node_.aliases(num); }
+
+    // Small products are fused into the destination and only need the
+    // scratch when their sign differs from it, so the scratch is sized up
+    // front only for trees that contain large products.
+    void addTo(BigInteger& result, bool subtract) const {
+        BigInteger scratch;
+        if (node_.productBound() >= 2 * kKaratsubaThreshold_) {
+            scratch.digits_.reserve(node_.productBound());
+        }
+        result.digits_.reserve(std::max(result.len(), node_.limbBound()) + 1);
+        node_.accumulate(result, subtract, scratch);
+    }
+
+  private:
+    Node node_;
+};
+
+inline BigInteger::Expr<BigInteger::ExprLeaf<const BigInteger&>>
+BigInteger::expr(const BigInteger& num) {
+    return Expr<ExprLeaf<const BigInteger&>>(
+        ExprLeaf<const BigInteger&>(num));
+}
+
+template <typename Node>
+BigInteger::BigInteger(const Expr<Node>& expression) : BigInteger() {
+    expression.addTo(*this, false);
+}
+
+template <typename Node>
+BigInteger& BigInteger::operator=(const Expr<Node>& expression) {
+    if (expression.aliases(this)) {
+        return *this = BigInteger(expression);
+    }
+    digits_.assign(1, 0);
+    is_negative_ = false;
+    expression.addTo(*this, false);
+    return *this;
+}
+
+template <typename Node>
+BigInteger& BigInteger::operator+=(const Expr<Node>& expression) {
+    if (expression.aliases(this)) {
+        return *this += BigInteger(expression);
+    }
+    expression.addTo(*this, false);
+    return *this;
+}
+
+template <typename Node>
+BigInteger& BigInteger::operator-=(const Expr<Node>& expression) {
+    if (expression.aliases(this)) {
+        return *this -= BigInteger(expression);
+    }
+    expression.addTo(*this, true);
+    return *this;
+}
+
+template <typename T>
+struct IsBigIntegerExpr : std::false_type {};
+
+template <typename Node>
+struct IsBigIntegerExpr<BigInteger::Expr<Node>> : std::true_type {};
+
+template <typename Node>
+const Node& toExprNode(const BigInteger::Expr<Node>& expression) {
+    return expression.node();
+}
+
+template <typename Node>
+Node toExprNode(BigInteger::Expr<Node>&& expression) {
+    return std::move(expression).node();
+}
+
+inline BigInteger::ExprLeaf<const BigInteger&> toExprNode(
+    const BigInteger& num) {
+    return BigInteger::ExprLeaf<const BigInteger&>(num);
+}
+
+inline BigInteger::ExprLeaf<BigInteger> toExprNode(BigInteger&& num) {
+    return BigInteger::ExprLeaf<BigInteger>(std::move(num));
+}
+
+template <typename Integer,
+          typename = std::enable_if_t<
+              std::is_integral_v<Integer> &&
+              !(std::is_unsigned_v<Integer> &&
+                sizeof(Integer) >= sizeof(int64_t))>>
+BigInteger::ExprScalar toExprNode(Integer num) {
+    return BigInteger::ExprScalar(static_cast<int64_t>(num));
+}
+
+template <typename Integer, EnableIfWideUnsigned<Integer> = 0>
+BigInteger::ExprLeaf<BigInteger> toExprNode(Integer num) {
+    return BigInteger::ExprLeaf<BigInteger>(BigInteger(num));
+}
+
+template <typename T>
+using ExprNodeOf = std::decay_t<decltype(toExprNode(std::declval<T>()))>;
+
+template <typename Left, typename Right>
+using EnableIfExpr =
+    std::enable_if_t<IsBigIntegerExpr<std::decay_t<Left>>::value ||
+                     IsBigIntegerExpr<std::decay_t<Right>>::value>;
+
+template <typename Left, typename Right, typename = EnableIfExpr<Left, Right>>
+auto operator+(Left&& left, Right&& right) {
+    using Node =
+        BigInteger::ExprSum<ExprNodeOf<Left>, ExprNodeOf<Right>, false>;
+    return BigInteger::Expr<Node>(Node(toExprNode(std::forward<Left>(left)),
+                                       toExprNode(std::forward<Right>(right))));
+}
+
+template <typename Left, typename Right, typename = EnableIfExpr<Left, Right>>
+auto operator-(Left&& left, Right&& right) {
+    using Node =
+        BigInteger::ExprSum<ExprNodeOf<Left>, ExprNodeOf<Right>, true>;
+    return BigInteger::Expr<Node>(Node(toExprNode(std::forward<Left>(left)),
+                                       toExprNode(std::forward<Right>(right))));
+}
+
+template <typename Left, typename Right, typename = EnableIfExpr<Left, Right>>
+auto operator*(Left&& left, Right&& right) {
+    using Node = BigInteger::ExprProduct<ExprNodeOf<Left>, ExprNodeOf<Right>>;
+    return BigInteger::Expr<Node>(Node(toExprNode(std::forward<Left>(left)),
+                                       toExprNode(std::forward<Right>(right))));
+}
+
+template <typename Node>
+auto operator-(const BigInteger::Expr<Node>& expression) {
+    return BigInteger::Expr<BigInteger::ExprNegation<Node>>(
+        BigInteger::ExprNegation<Node>(expression.node()));
+}
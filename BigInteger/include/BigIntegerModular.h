@@ -0,0 +1,61 @@
+#pragma once
+
+#include "BigInteger.h"
+
+// Arithmetic modulo a fixed positive modulus that is coprime to the limb
+// base (odd for base 2^64, coprime to 10 for base 10^9). Residues are
+// kept in Montgomery form x * R mod m with R = kBIBase_^n for an n-limb
+// modulus, so a product needs no division: REDC clears one low limb per
+// step by adding a multiple of the modulus.
+class BigInteger::Montgomery {
+  public:
+    explicit Montgomery(const BigInteger&);
+
+    static bool isSupported(const BigInteger&);
+
+    const BigInteger& modulus() const;
+
+    BigInteger toMontgomery(const BigInteger&) const;
+    BigInteger fromMontgomery(const BigInteger&) const;
+    BigInteger multiply(const BigInteger&, const BigInteger&) const;
+
+    // Takes and returns ordinary residues; the exponent must be
+    // nonnegative.
+    BigInteger pow(const BigInteger&, const BigInteger&) const;
+
+  private:
+    BigInteger modulus_;
+    BigInteger one_;
+    BigInteger r_squared_;
+    Limb inverse_;
+
+    void multiplyInto(BigInteger&, const BigInteger&, const BigInteger&,
+                      LimbVector&) const;
+    void reduce(LimbVector&, BigInteger&) const;
+
+    static Limb negatedInverse(Limb);
+};
+
+// Repeated division by one fixed divisor. Long divisors get a Barrett
+// reciprocal mu = floor(kBIBase_^(2n) / |d|) up front, after which each
+// n-limb block of the dividend costs two multiplications and at most two
+// corrections. Short divisors fall back to ordinary division. Results
+// follow the signs of divmod and operator%.
+class BigInteger::Divisor {
+  public:
+    explicit Divisor(const BigInteger&);
+
+    const BigInteger& divisor() const;
+
+    std::pair<BigInteger, BigInteger> divmod(const BigInteger&) const;
+    BigInteger reduce(const BigInteger&) const;
+    BigInteger mulmod(const BigInteger&, const BigInteger&) const;
+
+  private:
+    BigInteger divisor_;
+    BigInteger magnitude_;
+    BigInteger reciprocal_;
+
+    void divideMagnitude(const BigInteger&, BigInteger*, BigInteger&) const;
+    void divideBlock(const BigInteger&, BigInteger&, BigInteger&) const;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "BigInteger.h"
+
+// A serialized BigInteger inside a caller-owned buffer, such as a mapped
+// file. Construction validates the header and the length; the limbs are
+// only read by value, which copies them once when the limb format is the
+// native one.
+class BigInteger::View {
+  public:
+    View(const char*, size_t);
+
+    bool isNegative() const;
+    size_t limbCount() const;
+    // Length of the whole encoding, which is where the next one starts.
+    size_t encodedSize() const;
+
+    BigInteger value() const;
+
+  private:
+    const char* limbs_;
+    size_t limb_count_;
+    uint8_t format_;
+    bool is_negative_;
+};
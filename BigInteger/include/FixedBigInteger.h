@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+#include "BigInteger.h"
+#include "IntegerLiteral.h"
+
+// An integer of at most Limbs limbs in BigInteger's base (so the number
+// of limbs a value needs depends on the backend) whose value can be
+// computed at compile time:
+//
+//     constexpr FixedBigInteger<4> kPrime("0x1FFF'FFFF'FFFF'FFFF");
+//
+// Converting it to a BigInteger copies the limbs without any parsing.
+template <size_t Limbs>
+class FixedBigInteger {
+    static_assert(Limbs > 0, "FixedBigInteger needs at least one limb");
+
+  public:
+    constexpr FixedBigInteger() = default;
+    // Parses the text as an IntegerLiteral. Throws when the value needs
+    // more than Limbs limbs, which is a compile error in a constant
+    // expression.
+    constexpr explicit FixedBigInteger(std::string_view);
+
+    constexpr bool isNegative() const { return is_negative_; }
+
+    operator BigInteger() const;
+
+  private:
+    using Limb = BigInteger::Limb;
+    using DoubleLimb = BigInteger::DoubleLimb;
+
+    Limb limbs_[Limbs] = {};
+    size_t used_ = 0;
+    bool is_negative_ = false;
+
+    constexpr void multiplyAdd(DoubleLimb, Limb);
+};
+
+template <size_t Limbs>
+constexpr FixedBigInteger<Limbs>::FixedBigInteger(std::string_view text) {
+    // Digits come in chunks below kDecimalBase_, so that each chunk costs
+    // one pass over the limbs.
+    IntegerLiteral literal(text);
+    literal.forEachChunk(BigInteger::kDecimalBase_,
+                         [this](uint64_t scale, uint64_t chunk) {
+                             multiplyAdd(scale, static_cast<Limb>(chunk));
+                         });
+    is_negative_ = literal.isNegative() && used_ > 0;
+}
+
+template <size_t Limbs>
+FixedBigInteger<Limbs>::operator BigInteger() const {
+    BigInteger num;
+    if (used_ > 0) {
+        num.digits_.assign(limbs_, limbs_ + used_);
+    }
+    num.is_negative_ = is_negative_;
+    num.normalizeNum();
+    return num;
+}
+
+// Replaces the value with value * multiplier + addend.
+template <size_t Limbs>
+constexpr void FixedBigInteger<Limbs>::multiplyAdd(DoubleLimb multiplier,
+                                                   Limb addend) {
+    DoubleLimb carry = addend;
+    for (size_t i = 0; i < used_; ++i) {
+        DoubleLimb product = limbs_[i] * multiplier + carry;
+        limbs_[i] = static_cast<Limb>(product % BigInteger::kBIBase_);
+        carry = product / BigInteger::kBIBase_;
+    }
+    for (; carry != 0; ++used_) {
+        if (used_ == Limbs) {
+            throw std::invalid_argument("FixedBigInteger overflow");
+        }
+        limbs_[used_] = static_cast<Limb>(carry % BigInteger::kBIBase_);
+        carry /= BigInteger::kBIBase_;
+    }
+}
+
+// Integer literals of any length. The limbs are computed at compile time
+// and baked into the binary, so evaluating the literal only copies them.
+template <char... Digits>
+BigInteger operator"" _bi() {
+    static constexpr char kDigits[] = {Digits...};
+    static constexpr FixedBigInteger<sizeof...(Digits) * 4 /
+                                         BigInteger::kLimbBits_ +
+                                     1>
+        kValue(std::string_view(kDigits, sizeof...(Digits)));
+    return kValue;
+}
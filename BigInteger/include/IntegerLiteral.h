@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+
+// The text of an integer literal as FixedBigInteger and WideInt accept
+// it: an optional '-', then digits in the syntax of a C++ integer
+// literal, where a 0x, 0b or 0 prefix selects the radix and apostrophes
+// are skipped. Everything is constexpr so that both can be built from a
+// literal at compile time.
+class IntegerLiteral {
+  public:
+    // Throws on text without digits or with a digit outside the radix.
+    constexpr explicit IntegerLiteral(std::string_view);
+
+    constexpr bool isNegative() const { return is_negative_; }
+
+    // Calls consume(scale, chunk) for consecutive runs of digits, most
+    // significant first: chunk is the value of the run and scale, at most
+    // max_scale, is the radix to the power of its length. Folding them as
+    // value * scale + chunk gives the magnitude of the literal.
+    template <typename Consume>
+    constexpr void forEachChunk(uint64_t max_scale, Consume&& consume) const;
+
+  private:
+    std::string_view digits_;
+    unsigned radix_ = 10;
+    bool is_negative_ = false;
+
+    static constexpr unsigned digitValue(char);
+};
+
+constexpr IntegerLiteral::IntegerLiteral(std::string_view text) {
+    size_t i = 0;
+    if (i < text.size() && text[i] == '-') {
+        is_negative_ = true;
+        ++i;
+    }
+    if (text.size() - i > 1 && text[i] == '0') {
+        char prefix = text[i + 1];
+        if (prefix == 'x' || prefix == 'X') {
+            radix_ = 16;
+            i += 2;
+        } else if (prefix == 'b' || prefix == 'B') {
+            radix_ = 2;
+            i += 2;
+        } else {
+            radix_ = 8;
+            ++i;
+        }
+    }
+    digits_ = text.substr(i);
+    if (digits_.empty()) {
+        throw std::invalid_argument("Integer literal needs digits");
+    }
+    for (char symbol : digits_) {
+        if (symbol != '\'' && digitValue(symbol) >= radix_) {
+            throw std::invalid_argument("Invalid digit in integer literal");
+        }
+    }
+}
+
+template <typename Consume>
+constexpr void IntegerLiteral::forEachChunk(uint64_t max_scale,
+                                            Consume&& consume) const {
+    uint64_t chunk = 0;
+    uint64_t scale = 1;
+    for (char symbol : digits_) {
+        if (symbol == '\'') {
+            continue;
+        }
+        if (scale > max_scale / radix_) {
+            consume(scale, chunk);
+            chunk = 0;
+            scale = 1;
+        }
+        chunk = chunk * radix_ + digitValue(symbol);
+        scale *= radix_;
+    }
+    consume(scale, chunk);
+}
+
+constexpr unsigned IntegerLiteral::digitValue(char symbol) {
+    if (symbol >= '0' && symbol <= '9') {
+        return symbol - '0';
+    }
+    if (symbol >= 'a' && symbol <= 'f') {
+        return symbol - 'a' + 10;
+    }
+    if (symbol >= 'A' && symbol <= 'F') {
+        return symbol - 'A' + 10;
+    }
+    return 16;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <initializer_list>
+#include <vector>
+
+#include "BigInteger.h"
+#include "Rational.h"
+
+// Dense integer matrix with exact elimination. All algorithms use
+// fraction-free Bareiss elimination: every intermediate entry is a minor
+// of the original matrix, so entries grow linearly and each division is
+// exact. Rationals only appear in the result of solve.
+//
+// The row updates of an elimination step are independent; with threads
+// greater than one they are split between that many threads.
+class Matrix {
+  public:
+    Matrix(size_t, size_t);
+    Matrix(std::initializer_list<std::initializer_list<BigInteger>>);
+
+    size_t rows() const;
+    size_t columns() const;
+
+    BigInteger& operator()(size_t, size_t);
+    const BigInteger& operator()(size_t, size_t) const;
+
+    BigInteger determinant(size_t threads = 1) const;
+    size_t rank(size_t threads = 1) const;
+    // The unique solution of A x = b for a square nonsingular A.
+    std::vector<Rational> solve(const std::vector<BigInteger>&,
+                                size_t threads = 1) const;
+
+  private:
+    size_t rows_;
+    size_t columns_;
+    std::vector<BigInteger> entries_;
+
+    // Brings the first pivot_columns columns to fraction-free row echelon
+    // form and returns the rank. Stops at the first column without a
+    // pivot when full_rank is set.
+    size_t eliminate(size_t pivot_columns, bool full_rank, bool& negated,
+                     size_t threads);
+};
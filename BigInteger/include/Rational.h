@@ -1,5 +1,10 @@
 #pragma once
 
+#include <cstdint>
+#include <limits>
+#include <ostream>
+#include <type_traits>
+
 #include "BigInteger.h"
 
 class Rational {
@@ -7,30 +12,80 @@ class Rational {
     Rational();
     Rational(const BigInteger&);
     Rational(const BigInteger&, const BigInteger&);
-    Rational(int);
+    template <typename Integer,
+              typename = std::enable_if_t<std::is_integral_v<Integer>>>
+    Rational(Integer);
+    // Exact value of a finite double.
+    explicit Rational(double);
 
     std::string toString() const;
     std::string asDecimal(size_t) const;
+    // Writes the same digits as asDecimal, producing the fractional part
+    // in chunks so that the whole expansion is never held in memory.
+    void writeDecimal(std::ostream&, size_t) const;
     explicit operator double() const;
 
+    // The numerator and then the denominator in the binary encoding of
+    // BigInteger::serialize.
+    void serialize(std::ostream&) const;
+    static Rational deserialize(std::istream&);
+
     Rational operator-() const;
     Rational& operator+=(const Rational&);
     Rational& operator-=(const Rational&);
     Rational& operator*=(const Rational&);
     Rational& operator/=(const Rational&);
 
+    // A lazy rational skips the reduction to lowest terms after an
+    // operation until its numerator and denominator have doubled in size
+    // since the last reduction. toString still prints lowest terms.
+    void setLazy(bool);
+    bool isLazy() const;
+    void normalize();
+
     friend bool operator<(Rational, Rational);
 
   private:
+    static constexpr size_t kLazyMinLimbs_ = 16;
+    static constexpr size_t kDecimalChunkDigits_ = 4096;
+
     void toCoPrime();
+    void reduceIfNeeded();
+
+    // Values whose reduced numerator and denominator fit in int64_t are
+    // kept in the small fields and handled with overflow-checked machine
+    // arithmetic. An operation that would overflow promotes both operands
+    // to the BigInteger fields; a reduction that fits demotes again.
+    void promote();
+    void demote();
+    bool addSmall(int64_t, int64_t);
+    bool multiplySmall(int64_t, int64_t);
 
-    static BigInteger gcd(BigInteger, BigInteger);
     static BigInteger lms(BigInteger, BigInteger);
 
     BigInteger numerator_;
     BigInteger denominator_;
+    int64_t small_numerator_ = 0;
+    int64_t small_denominator_ = 1;
+    bool is_small_ = true;
+    bool is_lazy_ = false;
+    bool is_reduced_ = true;
+    size_t reduce_at_ = kLazyMinLimbs_;
 };
 
+template <typename Integer, typename>
+Rational::Rational(Integer num) {
+    if (std::is_signed_v<Integer> ||
+        static_cast<uint64_t>(num) <=
+            static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+        small_numerator_ = static_cast<int64_t>(num);
+    } else {
+        numerator_ = num;
+        denominator_ = 1;
+        is_small_ = false;
+    }
+}
+
 Rational operator+(Rational, const Rational&);
 Rational operator-(Rational, const Rational&);
 Rational operator*(Rational, const Rational&);
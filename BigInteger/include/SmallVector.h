@@ -0,0 +1,179 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+// Vector of trivially copyable elements that keeps up to InlineCapacity
+// elements inside the object and moves to the heap only when it grows
+// beyond that.
+template <typename T, size_t InlineCapacity>
+class SmallVector {
+    static_assert(std::is_trivially_copyable_v<T>);
+
+  public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() = default;
+
+    SmallVector(size_t count, const T& value) { assign(count, value); }
+
+    SmallVector(std::initializer_list<T> values) {
+        assign(values.begin(), values.end());
+    }
+
+    template <typename InputIt,
+              typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+    SmallVector(InputIt first, InputIt last) {
+        assign(first, last);
+    }
+
+    SmallVector(const SmallVector& other) {
+        assign(other.begin(), other.end());
+    }
+
+    SmallVector(SmallVector&& other) noexcept { steal(other); }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this != &other) {
+            release();
+            steal(other);
+        }
+        return *this;
+    }
+
+    ~SmallVector() { release(); }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+    bool isInline() const { return data_ == inline_; }
+
+    iterator begin() { return data_; }
+    iterator end() { return data_ + size_; }
+    const_iterator begin() const { return data_; }
+    const_iterator end() const { return data_ + size_; }
+
+    T& operator[](size_t index) { return data_[index]; }
+    const T& operator[](size_t index) const { return data_[index]; }
+
+    T& at(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("SmallVector index out of range");
+        }
+        return data_[index];
+    }
+    const T& at(size_t index) const {
+        return const_cast<SmallVector*>(this)->at(index);
+    }
+
+    T& back() { return data_[size_ - 1]; }
+    const T& back() const { return data_[size_ - 1]; }
+
+    void reserve(size_t new_capacity) {
+        if (new_capacity <= capacity_) {
+            return;
+        }
+        T* new_data = new T[new_capacity];
+        std::memcpy(new_data, data_, size_ * sizeof(T));
+        release();
+        data_ = new_data;
+        capacity_ = new_capacity;
+    }
+
+    void resize(size_t new_size, T value = T()) {
+        if (new_size > capacity_) {
+            reserve(std::max(new_size, 2 * capacity_));
+        }
+        if (new_size > size_) {
+            std::fill(data_ + size_, data_ + new_size, value);
+        }
+        size_ = new_size;
+    }
+
+    void push_back(T value) {
+        if (size_ == capacity_) {
+            reserve(2 * capacity_);
+        }
+        data_[size_++] = value;
+    }
+
+    void pop_back() { --size_; }
+    void clear() { size_ = 0; }
+
+    void assign(size_t count, T value) {
+        clear();
+        resize(count, value);
+    }
+
+    template <typename InputIt,
+              typename = std::enable_if_t<!std::is_integral_v<InputIt>>>
+    void assign(InputIt first, InputIt last) {
+        clear();
+        reserve(std::distance(first, last));
+        for (; first != last; ++first) {
+            data_[size_++] = *first;
+        }
+    }
+
+    iterator insert(const_iterator position, size_t count, const T& value) {
+        size_t index = position - data_;
+        size_t old_size = size_;
+        resize(size_ + count);
+        std::memmove(data_ + index + count, data_ + index,
+                     (old_size - index) * sizeof(T));
+        std::fill(data_ + index, data_ + index + count, value);
+        return data_ + index;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) {
+        size_t index = first - data_;
+        size_t count = last - first;
+        std::memmove(data_ + index, data_ + index + count,
+                     (size_ - index - count) * sizeof(T));
+        size_ -= count;
+        return data_ + index;
+    }
+
+  private:
+    T* data_ = inline_;
+    size_t size_ = 0;
+    size_t capacity_ = InlineCapacity;
+    T inline_[InlineCapacity];
+
+    void release() {
+        if (!isInline()) {
+            delete[] data_;
+        }
+        data_ = inline_;
+        capacity_ = InlineCapacity;
+    }
+
+    void steal(SmallVector& other) {
+        if (other.isInline()) {
+            std::memcpy(inline_, other.inline_, other.size_ * sizeof(T));
+        } else {
+            data_ = other.data_;
+            capacity_ = other.capacity_;
+            other.data_ = other.inline_;
+            other.capacity_ = InlineCapacity;
+        }
+        size_ = other.size_;
+        other.size_ = 0;
+    }
+};
@@ -0,0 +1,553 @@
+#pragma once
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "BigInteger.h"
+#include "IntegerLiteral.h"
+
+// Two's complement integer of Bits bits (a multiple of 64) held in 64-bit
+// limbs on the stack. Arithmetic wraps modulo 2^Bits like the built-in
+// integers; Signed only changes how values compare, divide and print.
+// Every operation loops over a limb count known at compile time, so the
+// compiler can unroll it, and nothing allocates.
+//
+//     WideInt<256> x = 12345678901234567890123_wi;
+//     WideInt<128, false> y("0xFFFF'FFFF'FFFF'FFFF'FFFF");
+//
+// Conversions that widen are implicit. Narrowing conversions and those
+// that only change signedness are explicit and keep the low Bits bits.
+template <size_t Bits, bool Signed = true>
+class WideInt {
+    static_assert(Bits > 0 && Bits % 64 == 0,
+                  "WideInt needs a positive multiple of 64 bits");
+
+  public:
+    constexpr WideInt() = default;
+    template <typename Integer,
+              typename = std::enable_if_t<std::is_integral_v<Integer>>>
+    constexpr WideInt(Integer);
+    template <size_t OtherBits, bool OtherSigned,
+              std::enable_if_t<(OtherBits < Bits), int> = 0>
+    constexpr WideInt(const WideInt<OtherBits, OtherSigned>&);
+    template <size_t OtherBits, bool OtherSigned,
+              std::enable_if_t<(OtherBits > Bits ||
+                                (OtherBits == Bits && OtherSigned != Signed)),
+                               int> = 0>
+    constexpr explicit WideInt(const WideInt<OtherBits, OtherSigned>&);
+    // Parses the text as an IntegerLiteral. Throws when the value does
+    // not fit, which is a compile error in a constant expression.
+    constexpr explicit WideInt(std::string_view);
+    // The low Bits bits of the two's complement value.
+    explicit WideInt(const BigInteger&);
+
+    constexpr WideInt operator-() const;
+
+    constexpr WideInt& operator+=(const WideInt&);
+    constexpr WideInt& operator-=(const WideInt&);
+    constexpr WideInt& operator*=(const WideInt&);
+    constexpr WideInt& operator/=(const WideInt&);
+    constexpr WideInt& operator%=(const WideInt&);
+
+    constexpr WideInt& operator++();
+    constexpr WideInt operator++(int);
+    constexpr WideInt& operator--();
+    constexpr WideInt operator--(int);
+
+    std::string toString() const;
+    constexpr bool isNegative() const;
+    // Number of bits in the magnitude, 0 for zero.
+    constexpr size_t bitLength() const;
+    // Low 64 bits of the two's complement value.
+    constexpr int64_t toInt64() const;
+
+    constexpr explicit operator bool() const;
+    explicit operator BigInteger() const;
+
+    friend constexpr WideInt operator+(WideInt num1, const WideInt& num2) {
+        return num1 += num2;
+    }
+    friend constexpr WideInt operator-(WideInt num1, const WideInt& num2) {
+        return num1 -= num2;
+    }
+    friend constexpr WideInt operator*(WideInt num1, const WideInt& num2) {
+        return num1 *= num2;
+    }
+    friend constexpr WideInt operator/(WideInt num1, const WideInt& num2) {
+        return num1 /= num2;
+    }
+    friend constexpr WideInt operator%(WideInt num1, const WideInt& num2) {
+        return num1 %= num2;
+    }
+
+    friend constexpr bool operator<(const WideInt& num1,
+                                    const WideInt& num2) {
+        return num1.compare(num2) < 0;
+    }
+    friend constexpr bool operator>(const WideInt& num1,
+                                    const WideInt& num2) {
+        return num1.compare(num2) > 0;
+    }
+    friend constexpr bool operator==(const WideInt& num1,
+                                     const WideInt& num2) {
+        return num1.compare(num2) == 0;
+    }
+    friend constexpr bool operator!=(const WideInt& num1,
+                                     const WideInt& num2) {
+        return num1.compare(num2) != 0;
+    }
+    friend constexpr bool operator<=(const WideInt& num1,
+                                     const WideInt& num2) {
+        return num1.compare(num2) <= 0;
+    }
+    friend constexpr bool operator>=(const WideInt& num1,
+                                     const WideInt& num2) {
+        return num1.compare(num2) >= 0;
+    }
+
+    friend std::ostream& operator<<(std::ostream& out, const WideInt& num) {
+        return out << num.toString();
+    }
+    friend std::istream& operator>>(std::istream& in, WideInt& num) {
+        std::string text;
+        if (in >> text) {
+            try {
+                num = WideInt(std::string_view(text));
+            } catch (const std::invalid_argument&) {
+                in.setstate(std::ios_base::failbit);
+            }
+        }
+        return in;
+    }
+
+    template <size_t OtherBits, bool OtherSigned>
+    friend class WideInt;
+
+  private:
+    using Limb = uint64_t;
+    using DoubleLimb = unsigned __int128;
+
+    static constexpr size_t kLimbs_ = Bits / 64;
+    static constexpr Limb kDecimalBase_ = 10'000'000'000'000'000'000ULL;
+    static constexpr size_t kDecimalBaseSize_ = 19;
+
+    Limb limbs_[kLimbs_] = {};
+
+    constexpr int compare(const WideInt&) const;
+    constexpr WideInt magnitude() const;
+    constexpr size_t usedLimbs() const;
+    // Replaces the value with value * multiplier + addend and returns the
+    // limb carried out of the top.
+    constexpr Limb multiplyAdd(Limb, Limb);
+    // Divides in place by a nonzero divisor and returns the remainder.
+    constexpr Limb divideBySmall(Limb);
+    // Unsigned division with Knuth's Algorithm D.
+    static constexpr void divideUnsigned(const WideInt&, const WideInt&,
+                                         WideInt&, WideInt&);
+};
+
+template <size_t Bits, bool Signed>
+template <typename Integer, typename>
+constexpr WideInt<Bits, Signed>::WideInt(Integer num) {
+    limbs_[0] = static_cast<Limb>(num);
+    if constexpr (std::is_signed_v<Integer>) {
+        for (size_t i = 1; i < kLimbs_; ++i) {
+            limbs_[i] = num < 0 ? ~Limb(0) : 0;
+        }
+    }
+}
+
+template <size_t Bits, bool Signed>
+template <size_t OtherBits, bool OtherSigned,
+          std::enable_if_t<(OtherBits < Bits), int>>
+constexpr WideInt<Bits, Signed>::WideInt(
+    const WideInt<OtherBits, OtherSigned>& num) {
+    for (size_t i = 0; i < num.kLimbs_; ++i) {
+        limbs_[i] = num.limbs_[i];
+    }
+    for (size_t i = num.kLimbs_; i < kLimbs_; ++i) {
+        limbs_[i] = num.isNegative() ? ~Limb(0) : 0;
+    }
+}
+
+template <size_t Bits, bool Signed>
+template <size_t OtherBits, bool OtherSigned,
+          std::enable_if_t<(OtherBits > Bits ||
+                            (OtherBits == Bits && OtherSigned != Signed)),
+                           int>>
+constexpr WideInt<Bits, Signed>::WideInt(
+    const WideInt<OtherBits, OtherSigned>& num) {
+    for (size_t i = 0; i < kLimbs_; ++i) {
+        limbs_[i] = num.limbs_[i];
+    }
+}
+
+template <size_t Bits, bool Signed>
+constexpr WideInt<Bits, Signed>::WideInt(std::string_view text) {
+    IntegerLiteral literal(text);
+    bool overflow = false;
+    literal.forEachChunk(kDecimalBase_,
+                         [this, &overflow](uint64_t scale, uint64_t chunk) {
+                             overflow |= multiplyAdd(scale, chunk) != 0;
+                         });
+    if (literal.isNegative()) {
+        *this = -*this;
+    }
+    // A signed value keeps its sign unless the magnitude took the sign bit.
+    if (overflow ||
+        (Signed && *this && isNegative() != literal.isNegative())) {
+        throw std::invalid_argument("WideInt overflow");
+    }
+}
+
+template <size_t Bits, bool Signed>
+WideInt<Bits, Signed>::WideInt(const BigInteger& num) {
+    const BigInteger::Limb* digits = num.digits_.data();
+#ifdef BIGINTEGER_BINARY_LIMBS
+    for (size_t i = 0; i < kLimbs_ && i < num.len(); ++i) {
+        limbs_[i] = digits[i];
+    }
+#else
+    for (size_t i = num.len(); i > 0; --i) {
+        multiplyAdd(BigInteger::kBIBase_, digits[i - 1]);
+    }
+#endif
+    if (num.is_negative_) {
+        *this = -*this;
+    }
+}
+
+template <size_t Bits, bool Signed>
+constexpr WideInt<Bits, Signed> WideInt<Bits, Signed>::operator-() const {
+    WideInt result;
+    Limb carry = 1;
+    for (size_t i = 0; i < kLimbs_; ++i) {
+        result.limbs_[i] = ~limbs_[i] + carry;
+        carry = carry != 0 && result.limbs_[i] == 0;
+    }
+    return result;
+}
+
+template <size_t Bits, bool Signed>
+constexpr WideInt<Bits, Signed>& WideInt<Bits, Signed>::operator+=(
+    const WideInt& num) {
+    Limb carry = 0;
+    for (size_t i = 0; i < kLimbs_; ++i) {
+        Limb sum = limbs_[i] + num.limbs_[i];
+        Limb next_carry = sum < limbs_[i];
+        limbs_[i] = sum + carry;
+        carry = next_carry | (limbs_[i] < carry);
+    }
+    return *this;
+}
+
+template <size_t Bits, bool Signed>
+constexpr WideInt<Bits, Signed>& WideInt<Bits, Signed>::operator-=(
+    const WideInt& num) {
+    Limb loan = 0;
+    for (size_t i = 0; i < kLimbs_; ++i) {
+        Limb difference = limbs_[i] - num.limbs_[i];
+        Limb next_loan = limbs_[i] < num.limbs_[i];
+        limbs_[i] = difference - loan;
+        loan = next_loan | (difference < loan);
+    }
+    return *this;
+}
+
+// Only the low kLimbs_ limbs of the product are computed.
+template <size_t Bits, bool Signed>
+constexpr WideInt<Bits, Signed>& WideInt<Bits, Signed>::operator*=(
+    const WideInt& num) {
+    Limb product[kLimbs_] = {};
+    for (size_t i = 0; i < kLimbs_; ++i) {
+        Limb carry = 0;
+        for (size_t j = 0; i + j < kLimbs_; ++j) {
+            DoubleLimb cur = DoubleLimb(limbs_[i]) * num.limbs_[j] +
+                             product[i + j] + carry;
+            product[i + j] = static_cast<Limb>(cur);
+            carry = static_cast<Limb>(cur >> 64);
+        }
+    }
+    for (size_t i = 0; i < kLimbs_; ++i) {
+        limbs_[i] = product[i];
+    }
+    return *this;
+}
+
+// Signed division truncates, so the remainder takes the sign of the
+// dividend, as for BigInteger.
+template <size_t Bits, bool Signed>
+constexpr WideInt<Bits, Signed>& WideInt<Bits, Signed>::operator/=(
+    const WideInt& num) {
+    WideInt quotient;
+    WideInt remainder;
+    divideUnsigned(magnitude(), num.magnitude(), quotient, remainder);
+    *this = isNegative() != num.isNegative() ? -quotient : quotient;
+    return *this;
+}
+
+template <size_t Bits, bool Signed>
+constexpr WideInt<Bits, Signed>& WideInt<Bits, Signed>::operator%=(
+    const WideInt& num) {
+    WideInt quotient;
+    WideInt remainder;
+    divideUnsigned(magnitude(), num.magnitude(), quotient, remainder);
+    *this = isNegative() ? -remainder : remainder;
+    return *this;
+}
+
+template <size_t Bits, bool Signed>
+constexpr WideInt<Bits, Signed>& WideInt<Bits, Signed>::operator++() {
+    for (size_t i = 0; i < kLimbs_ && ++limbs_[i] == 0; ++i) {
+    }
+    return *this;
+}
+
+template <size_t Bits, bool Signed>
+constexpr WideInt<Bits, Signed> WideInt<Bits, Signed>::operator++(int) {
+    WideInt old = *this;
+    ++*this;
+    return old;
+}
+
+template <size_t Bits, bool Signed>
+constexpr WideInt<Bits, Signed>& WideInt<Bits, Signed>::operator--() {
+    for (size_t i = 0; i < kLimbs_ && limbs_[i]-- == 0; ++i) {
+    }
+    return *this;
+}
+
+template <size_t Bits, bool Signed>
+constexpr WideInt<Bits, Signed> WideInt<Bits, Signed>::operator--(int) {
+    WideInt old = *this;
+    --*this;
+    return old;
+}
+
+template <size_t Bits, bool Signed>
+std::string WideInt<Bits, Signed>::toString() const {
+    WideInt rest = magnitude();
+    Limb chunks[kLimbs_ * 64 / 63 + 1] = {};
+    size_t count = 0;
+    do {
+        chunks[count++] = rest.divideBySmall(kDecimalBase_);
+    } while (rest);
+
+    std::string str = isNegative() ? "-" : "";
+    str += std::to_string(chunks[count - 1]);
+    for (size_t i = count - 1; i > 0; --i) {
+        std::string chunk = std::to_string(chunks[i - 1]);
+        str.append(kDecimalBaseSize_ - chunk.size(), '0');
+        str += chunk;
+    }
+    return str;
+}
+
+template <size_t Bits, bool Signed>
+constexpr bool WideInt<Bits, Signed>::isNegative() const {
+    return Signed && (limbs_[kLimbs_ - 1] >> 63) != 0;
+}
+
+template <size_t Bits, bool Signed>
+constexpr size_t WideInt<Bits, Signed>::bitLength() const {
+    WideInt abs = magnitude();
+    size_t used = abs.usedLimbs();
+    if (used == 0) {
+        return 0;
+    }
+    return 64 * used - __builtin_clzll(abs.limbs_[used - 1]);
+}
+
+template <size_t Bits, bool Signed>
+constexpr int64_t WideInt<Bits, Signed>::toInt64() const {
+    return static_cast<int64_t>(limbs_[0]);
+}
+
+template <size_t Bits, bool Signed>
+constexpr WideInt<Bits, Signed>::operator bool() const {
+    return usedLimbs() != 0;
+}
+
+// Decimal limbs are filled two at a time from remainders modulo 10^18.
+template <size_t Bits, bool Signed>
+WideInt<Bits, Signed>::operator BigInteger() const {
+    WideInt rest = magnitude();
+    BigInteger num;
+#ifdef BIGINTEGER_BINARY_LIMBS
+    num.digits_.assign(rest.limbs_, rest.limbs_ + kLimbs_);
+#else
+    const Limb kBase = BigInteger::kDecimalBase_;
+    num.digits_.clear();
+    while (rest) {
+        Limb chunk = rest.divideBySmall(kBase * kBase);
+        num.digits_.push_back(static_cast<BigInteger::Limb>(chunk % kBase));
+        num.digits_.push_back(static_cast<BigInteger::Limb>(chunk / kBase));
+    }
+#endif
+    num.is_negative_ = isNegative();
+    num.normalizeNum();
+    return num;
+}
+
+template <size_t Bits, bool Signed>
+constexpr int WideInt<Bits, Signed>::compare(const WideInt& num) const {
+    if (isNegative() != num.isNegative()) {
+        return isNegative() ? -1 : 1;
+    }
+    for (size_t i = kLimbs_; i > 0; --i) {
+        if (limbs_[i - 1] != num.limbs_[i - 1]) {
+            return limbs_[i - 1] < num.limbs_[i - 1] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+template <size_t Bits, bool Signed>
+constexpr WideInt<Bits, Signed> WideInt<Bits, Signed>::magnitude() const {
+    return isNegative() ? -*this : *this;
+}
+
+template <size_t Bits, bool Signed>
+constexpr size_t WideInt<Bits, Signed>::usedLimbs() const {
+    size_t used = kLimbs_;
+    while (used > 0 && limbs_[used - 1] == 0) {
+        --used;
+    }
+    return used;
+}
+
+template <size_t Bits, bool Signed>
+constexpr typename WideInt<Bits, Signed>::Limb
+WideInt<Bits, Signed>::multiplyAdd(Limb multiplier, Limb addend) {
+    Limb carry = addend;
+    for (size_t i = 0; i < kLimbs_; ++i) {
+        DoubleLimb cur = DoubleLimb(limbs_[i]) * multiplier + carry;
+        limbs_[i] = static_cast<Limb>(cur);
+        carry = static_cast<Limb>(cur >> 64);
+    }
+    return carry;
+}
+
+template <size_t Bits, bool Signed>
+constexpr typename WideInt<Bits, Signed>::Limb
+WideInt<Bits, Signed>::divideBySmall(Limb divisor) {
+    DoubleLimb remainder = 0;
+    for (size_t i = kLimbs_; i > 0; --i) {
+        DoubleLimb cur = (remainder << 64) | limbs_[i - 1];
+        limbs_[i - 1] = static_cast<Limb>(cur / divisor);
+        remainder = cur % divisor;
+    }
+    return static_cast<Limb>(remainder);
+}
+
+// Both operands are normalized so that the top limb of the divisor has
+// its high bit set; then each quotient limb estimated from the top two
+// limbs of the running remainder is at most one too large after the
+// correction loop, and the final add-back fixes that case.
+template <size_t Bits, bool Signed>
+constexpr void WideInt<Bits, Signed>::divideUnsigned(const WideInt& num1,
+                                                     const WideInt& num2,
+                                                     WideInt& quotient,
+                                                     WideInt& remainder) {
+    size_t len2 = num2.usedLimbs();
+    if (len2 == 0) {
+        throw std::invalid_argument("Division by zero");
+    }
+    size_t len1 = num1.usedLimbs();
+    quotient = WideInt();
+    remainder = WideInt();
+    if (len1 < len2) {
+        remainder = num1;
+        return;
+    }
+    if (len2 == 1) {
+        quotient = num1;
+        remainder.limbs_[0] = quotient.divideBySmall(num2.limbs_[0]);
+        return;
+    }
+
+    unsigned shift = __builtin_clzll(num2.limbs_[len2 - 1]);
+    Limb divisor[kLimbs_] = {};
+    Limb rest[kLimbs_ + 1] = {};
+    for (size_t i = 0; i < len2; ++i) {
+        divisor[i] = num2.limbs_[i] << shift;
+        if (shift != 0 && i > 0) {
+            divisor[i] |= num2.limbs_[i - 1] >> (64 - shift);
+        }
+    }
+    for (size_t i = 0; i <= len1; ++i) {
+        Limb low = i > 0 && shift != 0 ? num1.limbs_[i - 1] >> (64 - shift)
+                                       : 0;
+        rest[i] = (i < len1 ? num1.limbs_[i] << shift : 0) | low;
+    }
+
+    Limb top = divisor[len2 - 1];
+    Limb next = divisor[len2 - 2];
+    for (size_t j = len1 - len2 + 1; j > 0; --j) {
+        size_t pos = j - 1;
+        DoubleLimb cur =
+            (DoubleLimb(rest[pos + len2]) << 64) | rest[pos + len2 - 1];
+        DoubleLimb estimate = cur / top;
+        DoubleLimb estimate_rest = cur % top;
+        while (estimate >> 64 != 0 ||
+               estimate * next >
+                   ((estimate_rest << 64) | rest[pos + len2 - 2])) {
+            --estimate;
+            estimate_rest += top;
+            if (estimate_rest >> 64 != 0) {
+                break;
+            }
+        }
+
+        Limb digit = static_cast<Limb>(estimate);
+        Limb carry = 0;
+        Limb loan = 0;
+        for (size_t i = 0; i < len2; ++i) {
+            DoubleLimb product = DoubleLimb(digit) * divisor[i] + carry;
+            carry = static_cast<Limb>(product >> 64);
+            Limb low = static_cast<Limb>(product);
+            Limb difference = rest[pos + i] - low;
+            Limb next_loan = rest[pos + i] < low;
+            rest[pos + i] = difference - loan;
+            loan = next_loan | (difference < loan);
+        }
+        Limb difference = rest[pos + len2] - carry;
+        bool negative = rest[pos + len2] < carry || difference < loan;
+        rest[pos + len2] = difference - loan;
+
+        if (negative) {
+            --digit;
+            Limb add_carry = 0;
+            for (size_t i = 0; i < len2; ++i) {
+                Limb sum = rest[pos + i] + divisor[i];
+                Limb next_carry = sum < divisor[i];
+                rest[pos + i] = sum + add_carry;
+                add_carry = next_carry | (rest[pos + i] < add_carry);
+            }
+            rest[pos + len2] += add_carry;
+        }
+        quotient.limbs_[pos] = digit;
+    }
+
+    for (size_t i = 0; i < len2; ++i) {
+        remainder.limbs_[i] = rest[i] >> shift;
+        if (shift != 0) {
+            remainder.limbs_[i] |= rest[i + 1] << (64 - shift);
+        }
+    }
+}
+
+// The literal is parsed at compile time into the narrowest signed WideInt
+// that holds it, which widens implicitly to the type it is used with.
+template <char... Digits>
+constexpr auto operator"" _wi() {
+    constexpr char kDigits[] = {Digits...};
+    constexpr WideInt<(sizeof...(Digits) * 4 / 64 + 1) * 64, false> kValue(
+        std::string_view(kDigits, sizeof...(Digits)));
+    return WideInt<(kValue.bitLength() / 64 + 1) * 64>(kValue);
+}
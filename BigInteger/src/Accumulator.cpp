@@ -0,0 +1,90 @@
+#include "BigIntegerAccumulator.h"
+
+BigInteger::Accumulator& BigInteger::Accumulator::operator+=(
+    const BigInteger& num) {
+    reserve(1);
+    addColumns(num.is_negative_ ? negative_ : positive_,
+               num.digits_.data(), num.len());
+    return *this;
+}
+
+BigInteger::Accumulator& BigInteger::Accumulator::operator-=(
+    const BigInteger& num) {
+    reserve(1);
+    addColumns(num.is_negative_ ? positive_ : negative_,
+               num.digits_.data(), num.len());
+    return *this;
+}
+
+BigInteger::Accumulator& BigInteger::Accumulator::operator+=(
+    const Accumulator& other) {
+    if (&other == this) {
+        Accumulator copy = other;
+        return *this += copy;
+    }
+    reserve(other.pending_);
+    addColumns(positive_, other.positive_);
+    addColumns(negative_, other.negative_);
+    return *this;
+}
+
+BigInteger BigInteger::Accumulator::finish() {
+    propagate(positive_);
+    propagate(negative_);
+    pending_ = 1;
+    BigInteger total = toNumber(positive_);
+    total -= toNumber(negative_);
+    return total;
+}
+
+// Makes room for terms that add up to count * kBIBase_ per column.
+void BigInteger::Accumulator::reserve(size_t count) {
+    if (pending_ + count > kCarryInterval_) {
+        propagate(positive_);
+        propagate(negative_);
+        pending_ = 1;
+    }
+    pending_ += count;
+}
+
+void BigInteger::Accumulator::addColumns(std::vector<DoubleLimb>& columns,
+                                         const Limb* limbs, size_t len) {
+    if (columns.size() < len) {
+        columns.resize(len, 0);
+    }
+    for (size_t i = 0; i < len; ++i) {
+        columns[i] += limbs[i];
+    }
+}
+
+void BigInteger::Accumulator::addColumns(
+    std::vector<DoubleLimb>& columns, const std::vector<DoubleLimb>& other) {
+    if (columns.size() < other.size()) {
+        columns.resize(other.size(), 0);
+    }
+    for (size_t i = 0; i < other.size(); ++i) {
+        columns[i] += other[i];
+    }
+}
+
+void BigInteger::Accumulator::propagate(std::vector<DoubleLimb>& columns) {
+    DoubleLimb carry = 0;
+    for (DoubleLimb& column : columns) {
+        column += carry;
+        carry = column / kBIBase_;
+        column %= kBIBase_;
+    }
+    while (carry != 0) {
+        columns.push_back(carry % kBIBase_);
+        carry /= kBIBase_;
+    }
+}
+
+// Expects propagated columns.
+BigInteger BigInteger::Accumulator::toNumber(
+    const std::vector<DoubleLimb>& columns) {
+    BigInteger num;
+    num.digits_.assign(columns.begin(), columns.end());
+    num.normalizeNum();
+    return num;
+}
@@ -1,50 +1,70 @@
+#include <cmath>
 #include <cstring>
 #include <algorithm>
 #include <iostream>
 
-#include "BigInteger.h"
+#include "LimbArithmetic.h"
 
-BigInteger::BigInteger() : digits_ {0}, is_negative_(false) {}
+namespace {
+  uint64_t magnitudeOf(int64_t num) {
+    uint64_t magnitude = static_cast<uint64_t>(num);
+    return num < 0 ? 0 - magnitude : magnitude;
+  }
 
-BigInteger::BigInteger(int num) {
-    is_negative_ = (num < 0);
-    num = std::abs(num);
-    do {
-        digits_.push_back(num % kBIBase_);
-        num /= kBIBase_;
-    } while (num > 0);
-    normalizeNum();
+  BigInteger raise(BigInteger base, size_t exponent) {
+    BigInteger power = 1;
+    for (; exponent > 0; exponent >>= 1) {
+        if (exponent & 1) {
+            power *= base;
+        }
+        if (exponent > 1) {
+            base *= base;
+        }
+    }
+    return power;
+  }
 }
 
+BigInteger::BigInteger() : digits_ {0}, is_negative_(false) {}
+
 BigInteger::BigInteger(const char* num) : is_negative_(false) {
     if (num[0] == '-') {
         is_negative_ = true;
     }
-    int cur_pos = strlen(num) - kBIBaseSize_;
-    int prev_pos = strlen(num) - 1;
-    int min_index = is_negative_ ? 1 : 0;
-    std::string subStr;
-    subStr.resize(kBIBaseSize_);
-    for (; cur_pos >= min_index; cur_pos -= kBIBaseSize_) {
-        strncpy(&subStr[0], num + cur_pos, prev_pos - cur_pos + 1);
-        digits_.push_back(std::stoll(subStr));
-        prev_pos = cur_pos - 1;
-    }
-    if (prev_pos != min_index - 1) {
-        subStr.resize(prev_pos - min_index + 1);
-        strncpy(&subStr[0], num + min_index, subStr.size());
-        digits_.push_back(std::stoll(subStr));
-    }
-    normalizeNum();
+    size_t min_index = is_negative_ ? 1 : 0;
+    *this = fromDigits(num + min_index, strlen(num) - min_index,
+                       is_negative_);
 }
 
 BigInteger::BigInteger(const std::string& num) : BigInteger(num.data()) {}
 
-BigInteger BigInteger::operator-() const {
+BigInteger::BigInteger(BigInteger&& num) noexcept
+    : digits_(std::move(num.digits_)), is_negative_(num.is_negative_) {
+    num.digits_.assign(1, 0);
+    num.is_negative_ = false;
+}
+
+// The moved-from number keeps the old buffer, so a temporary that is
+// assigned from in a loop does not reallocate on the next iteration.
+BigInteger& BigInteger::operator=(BigInteger&& num) noexcept {
+    if (this != &num) {
+        std::swap(digits_, num.digits_);
+        is_negative_ = num.is_negative_;
+        num.digits_.assign(1, 0);
+        num.is_negative_ = false;
+    }
+    return *this;
+}
+
+BigInteger BigInteger::operator-() const& {
     BigInteger opposite_num = *this;
-    opposite_num.is_negative_ = !opposite_num.is_negative_;
-    opposite_num.normalizeNum();
-    return opposite_num;
+    return -std::move(opposite_num);
+}
+
+BigInteger BigInteger::operator-() && {
+    is_negative_ = !is_negative_;
+    normalizeNum();
+    return std::move(*this);
 }
 
 BigInteger& BigInteger::operator+=(const BigInteger& num) {
@@ -66,90 +86,96 @@ BigInteger& BigInteger::operator-=(const BigInteger& num) {
 }
 
 BigInteger& BigInteger::operator*=(const BigInteger& num) {
-    if (num == BigInteger(-1) && *this != BigInteger(0)) {
-        is_negative_ = !is_negative_;
-        return *this;
-    }
-    BigInteger result;
-    const BigInteger* bigger_num = &num;
-    const BigInteger* smaller_num = this;
-    if (num.len() < len()) {
-        std::swap(bigger_num, smaller_num);
-    }
-    size_t minimum_digit = smaller_num->len();
-    size_t maximum_digit = bigger_num->len();
-    for (size_t i = 0; i < minimum_digit; ++i) {
-        BigInteger presum;
-        presum.digits_.resize(maximum_digit + i, 0);
-        long long next_digit = 0;
-        for (size_t j = 0; j < maximum_digit; ++j) {
-            long long cur_digit =
-                smaller_num->digits_[i] * bigger_num->digits_[j] + next_digit;
-            presum.digits_[j + i] = cur_digit % kBIBase_;
-            next_digit = cur_digit / kBIBase_;
-        }
-        presum.digits_.push_back(next_digit);
-        result += presum;
+    bool is_negative = is_negative_ != num.is_negative_;
+    if (num.len() == 1) {
+        multiplyBySmall(num.digits_[0]);
+    } else if (len() == 1) {
+        Limb multiplier = digits_[0];
+        digits_ = num.digits_;
+        multiplyBySmall(multiplier);
+    } else {
+        BigInteger product;
+        product.assignProduct(*this, num);
+        std::swap(digits_, product.digits_);
     }
-    result.is_negative_ = smaller_num->is_negative_ != bigger_num->is_negative_;
-    result.normalizeNum();
-    *this = result;
+    is_negative_ = is_negative;
+    normalizeNum();
     return *this;
 }
 
 BigInteger& BigInteger::operator/=(const BigInteger& num) {
-    BigInteger divider = num;
-    BigInteger result;
-    result.is_negative_ = is_negative_ != num.is_negative_;
-    result.digits_.resize(0);
-
-    is_negative_ = false;
-    divider.is_negative_ = false;
-
-    if (*this < divider) {
-        return *this = 0;
-    }
-
-    BigInteger subNum = getSubNum(len() - divider.len(), len() - 1);
-    long long last_digit = divider.len() + 1;
-
-    for (size_t i = last_digit; i <= len() + 1; ++i) {
-        long long left_edge = 0;
-        long long right_edge = kBIBase_;
-        while (right_edge - left_edge > 1) {
-            long long medium = (left_edge + right_edge) / 2;
-            if (divider * medium > subNum) {
-                right_edge = medium;
-            } else {
-                left_edge = medium;
-            }
-        }
-        result.digits_.push_back(left_edge);
-        if (i <= len()) {
-            subNum -= (divider * left_edge);
-            subNum *= kBIBase_;
-            subNum += digits_.at(len() - i);
-        }
+    if (num.len() == 1) {
+        bool is_negative = is_negative_ != num.is_negative_;
+        divideBySmall(num.digits_[0]);
+        is_negative_ = is_negative;
+        normalizeNum();
+        return *this;
     }
-    *this = result;
-    reverseNum();
-    normalizeNum();
+    *this = std::move(divmod(*this, num).first);
     return *this;
 }
 
 BigInteger& BigInteger::operator%=(const BigInteger& num) {
-    *this -= num * (*this / num);
+    if (num.len() == 1) {
+        bool is_negative = is_negative_;
+        digits_.assign(1, divideBySmall(num.digits_[0]));
+        is_negative_ = is_negative;
+        normalizeNum();
+        return *this;
+    }
+    *this = std::move(divmod(*this, num).second);
+    return *this;
+}
+
+// A machine integer whose magnitude does not fit one limb (decimal limbs
+// only) goes through a temporary, which still stays in inline storage.
+BigInteger& BigInteger::operator+=(int64_t num) {
+    uint64_t magnitude = magnitudeOf(num);
+    if (magnitude >= kBIBase_) {
+        return *this += BigInteger(num);
+    }
+    addSmall(static_cast<Limb>(magnitude), num < 0);
+    return *this;
+}
+
+BigInteger& BigInteger::operator-=(int64_t num) {
+    uint64_t magnitude = magnitudeOf(num);
+    if (magnitude >= kBIBase_) {
+        return *this -= BigInteger(num);
+    }
+    addSmall(static_cast<Limb>(magnitude), num > 0);
+    return *this;
+}
+
+BigInteger& BigInteger::operator*=(int64_t num) {
+    uint64_t magnitude = magnitudeOf(num);
+    if (magnitude >= kBIBase_) {
+        return *this *= BigInteger(num);
+    }
+    bool is_negative = is_negative_ != (num < 0);
+    multiplyBySmall(static_cast<Limb>(magnitude));
+    is_negative_ = is_negative;
     normalizeNum();
     return *this;
 }
 
+BigInteger& BigInteger::operator/=(int64_t num) {
+    divideByInteger(num);
+    return *this;
+}
+
+BigInteger& BigInteger::operator%=(int64_t num) {
+    *this = BigInteger(divideByInteger(num));
+    return *this;
+}
+
 BigInteger& BigInteger::operator++() {
-    is_negative_ ? absoluteSubtraction(1) : absoluteSum(1);
+    addSmall(1, false);
     return *this;
 }
 
 BigInteger& BigInteger::operator--() {
-    is_negative_ ? absoluteSum(1) : absoluteSubtraction(1);
+    addSmall(1, true);
     return *this;
 }
 
@@ -166,27 +192,93 @@ BigInteger BigInteger::operator--(int) {
 }
 
 void BigInteger::normalizeNum() {
-    if (digits_.size() == 1 && digits_.at(0) == 0) {
-        is_negative_ = false;
+    if (digits_.empty()) {
+        digits_.push_back(0);
     }
-    long long cur_ind = digits_.size() - 1;
-    while (digits_.at(cur_ind) == 0 && cur_ind > 0) {
+    while (digits_.size() > 1 && digits_.back() == 0) {
         digits_.pop_back();
-        --cur_ind;
+    }
+    if (digits_.size() == 1 && digits_[0] == 0) {
+        is_negative_ = false;
     }
 }
 
-void BigInteger::reverseNum() { std::reverse(digits_.begin(), digits_.end()); }
 size_t BigInteger::len() const { return digits_.size(); }
 
-BigInteger BigInteger::getSubNum(size_t start, size_t end) const {
-    BigInteger subNum;
-    subNum.digits_.resize(end - start + 1);
-    for (size_t i = start; i <= end; ++i) {
-        subNum.digits_.at(i - start) = digits_.at(i);
+size_t BigInteger::limbCount() const { return digits_.size(); }
+
+// Number of bits in the magnitude, 0 for zero. With decimal limbs the
+// leading limbs give log2 in floating point, which is only checked
+// against an exact power of two when it lands next to an integer.
+size_t BigInteger::bitLength() const {
+    if (isZero()) {
+        return 0;
+    }
+    Limb top = digits_.back();
+    size_t top_bits = 64 - __builtin_clzll(top);
+    if (kBIBase_ != kDecimalBase_) {
+        return (len() - 1) * sizeof(Limb) * 8 + top_bits;
+    }
+    if (len() == 1) {
+        return top_bits;
+    }
+    double leading = double(top) * kBIBase_ + digits_[len() - 2];
+    double estimate =
+        std::log2(leading) + (len() - 2) * std::log2(double(kBIBase_));
+    double fraction = estimate - std::floor(estimate);
+    if (fraction > 1e-6 && fraction < 1 - 1e-6) {
+        return size_t(estimate) + 1;
+    }
+    size_t boundary = size_t(std::llround(estimate));
+    return absoluteComparison(powerOfTwo(boundary)) >= 0 ? boundary + 1
+                                                         : boundary;
+}
+
+int64_t BigInteger::toInt64() const {
+    uint64_t magnitude = 0;
+    for (size_t i = len(); i > 0; --i) {
+        magnitude =
+            static_cast<uint64_t>(magnitude * kBIBase_ + digits_[i - 1]);
     }
-    subNum.normalizeNum();
-    return subNum;
+    return static_cast<int64_t>(is_negative_ ? 0 - magnitude : magnitude);
+}
+
+BigInteger BigInteger::powerOfTwo(size_t exponent) {
+    BigInteger power;
+    if (kBIBase_ != kDecimalBase_) {
+        size_t limb_bits = sizeof(Limb) * 8;
+        power.digits_.assign(exponent / limb_bits + 1, 0);
+        power.digits_.back() = Limb(1) << (exponent % limb_bits);
+        return power;
+    }
+    power = int64_t(1) << (exponent % 62);
+    power *= raise(int64_t(1) << 62, exponent / 62);
+    return power;
+}
+
+// With decimal limbs the limb part of a power of ten is a shift.
+BigInteger BigInteger::powerOfTen(size_t exponent) {
+    BigInteger power = 1;
+    for (size_t i = 0; i < exponent % kBIBaseSize_; ++i) {
+        power.multiplyBySmall(10);
+    }
+    if (kBIBase_ == kDecimalBase_) {
+        power.shiftLimbsLeft(exponent / kBIBaseSize_);
+    } else {
+        power *= raise(kDecimalBase_, exponent / kBIBaseSize_);
+    }
+    return power;
+}
+
+void BigInteger::shiftLimbsLeft(size_t count) {
+    if (!isZero()) {
+        digits_.insert(digits_.begin(), count, 0);
+    }
+}
+
+void BigInteger::shiftLimbsRight(size_t count) {
+    digits_.erase(digits_.begin(), digits_.begin() + std::min(count, len()));
+    normalizeNum();
 }
 
 bool BigInteger::isZero() const {
@@ -194,46 +286,93 @@ bool BigInteger::isZero() const {
 }
 
 void BigInteger::absoluteSum(const BigInteger& num) {
-    if (num.len() >= len()) {
-        digits_.resize(num.len() + 1);
-    }
-    long long next_digit = 0;
-    for (size_t i = 0; i < len(); ++i) {
-        long long cur_digit = digits_[i];
-        long long digit_of_num = i < num.len() ? num.digits_.at(i) : 0;
-        digits_[i] = (cur_digit + digit_of_num + next_digit) % kBIBase_;
-        next_digit = (cur_digit + digit_of_num + next_digit) / kBIBase_;
-
-        if (next_digit == 0 && i > num.len()) {
-            break;
-        }
+    if (num.len() > len()) {
+        digits_.resize(num.len(), 0);
+    }
+    Limb carry = addLimbs(digits_.data(), len(), num.digits_.data(), num.len());
+    if (carry != 0) {
+        digits_.push_back(carry);
     }
-    digits_.at(len() - 1) += next_digit;
     normalizeNum();
 }
 
 void BigInteger::absoluteSubtraction(const BigInteger& num) {
-    const BigInteger* bigger_num = this;
-    const BigInteger* smaller_num = &num;
-
     if (absoluteComparison(num) == -1) {
         is_negative_ = !is_negative_;
-        std::swap(bigger_num, smaller_num);
-        digits_.resize(num.len());
-    }
-    int loan = 0;
-    for (size_t i = 0; i < bigger_num->len(); ++i) {
-        long long cur_digit = bigger_num->digits_.at(i) - loan;
-        long long num_digit =
-            i >= smaller_num->len() ? 0 : smaller_num->digits_.at(i);
-        long long delta = cur_digit - num_digit;
-        loan = 0;
-        if (delta < 0) {
-            loan = 1;
+        digits_.resize(num.len(), 0);
+        subtractFromLimbs(digits_.data(), num.digits_.data(), num.len());
+    } else {
+        subtractLimbs(digits_.data(), len(), num.digits_.data(), num.len());
+    }
+    normalizeNum();
+}
+
+void BigInteger::assignInteger(uint64_t magnitude, bool is_negative) {
+    digits_.clear();
+    do {
+        digits_.push_back(static_cast<Limb>(magnitude % kBIBase_));
+        magnitude = static_cast<uint64_t>(magnitude / kBIBase_);
+    } while (magnitude > 0);
+    is_negative_ = is_negative;
+    normalizeNum();
+}
+
+// Adds a single limb with the given sign.
+void BigInteger::addSmall(Limb magnitude, bool is_negative) {
+    if (isZero()) {
+        is_negative_ = is_negative;
+    }
+    if (is_negative == is_negative_) {
+        Limb carry = addLimbs(digits_.data(), len(), &magnitude, 1);
+        if (carry != 0) {
+            digits_.push_back(carry);
+        }
+    } else if (len() > 1 || digits_[0] >= magnitude) {
+        subtractLimbs(digits_.data(), len(), &magnitude, 1);
+    } else {
+        digits_[0] = magnitude - digits_[0];
+        is_negative_ = is_negative;
+    }
+    normalizeNum();
+}
+
+// Truncating division; returns the remainder, which takes the sign of the
+// dividend.
+int64_t BigInteger::divideByInteger(int64_t num) {
+    bool is_negative = is_negative_;
+    uint64_t magnitude = magnitudeOf(num);
+    uint64_t remainder = 0;
+    if (magnitude < kBIBase_) {
+        remainder = divideBySmall(static_cast<Limb>(magnitude));
+    } else {
+        auto [quotient, rest] = divmod(*this, BigInteger(num));
+        for (size_t i = rest.len(); i > 0; --i) {
+            remainder = static_cast<uint64_t>(remainder * kBIBase_ +
+                                              rest.digits_[i - 1]);
         }
-        digits_.at(i) = moduloBase(delta);
+        digits_ = std::move(quotient.digits_);
     }
+    is_negative_ = is_negative != (num < 0);
     normalizeNum();
+    int64_t signed_remainder = static_cast<int64_t>(remainder);
+    return is_negative ? -signed_remainder : signed_remainder;
+}
+
+int BigInteger::compareWithInteger(int64_t num) const {
+    bool is_negative = num < 0;
+    if (is_negative_ != is_negative) {
+        return is_negative_ ? -1 : 1;
+    }
+    uint64_t magnitude = magnitudeOf(num);
+    int compare = 0;
+    if (magnitude >= kBIBase_) {
+        compare = absoluteComparison(BigInteger(num));
+    } else if (len() > 1) {
+        compare = 1;
+    } else {
+        compare = (digits_[0] > magnitude) - (digits_[0] < magnitude);
+    }
+    return is_negative ? -compare : compare;
 }
 
 int BigInteger::absoluteComparison(const BigInteger& num) const {
@@ -243,31 +382,32 @@ int BigInteger::absoluteComparison(const BigInteger& num) const {
     if (len() > num.len()) {
         return 1;
     }
-    for (size_t i = num.len(); i > 0; --i) {
-        long long ind = i - 1;
-        if (digits_.at(ind) < num.digits_.at(ind)) {
-            return -1;
-        } else if (digits_.at(ind) > num.digits_.at(ind)) {
-            return 1;
+    if (len() >= kVectorThreshold_ && hasVectorKernels()) {
+        return compareLimbsVector(digits_.data(), num.digits_.data(), len());
+    }
+    for (size_t i = len(); i > 0; --i) {
+        if (digits_[i - 1] != num.digits_[i - 1]) {
+            return digits_[i - 1] < num.digits_[i - 1] ? -1 : 1;
         }
     }
     return 0;
 }
 
 std::string BigInteger::toString() const {
+    LimbVector chunks = toDecimalChunks();
     std::string ans;
-    ans.reserve(kBIBaseSize_ * len() + 1);
+    ans.reserve(kBIBaseSize_ * chunks.size() + 1);
     if (is_negative_) {
         ans += '-';
     }
-    addLeadingZeroes(ans, digits_.at(len() - 1), true);
-    for (size_t i = len() - 1; i > 0; --i) {
-        addLeadingZeroes(ans, digits_.at(i - 1), false);
+    addLeadingZeroes(ans, chunks.back(), true);
+    for (size_t i = chunks.size() - 1; i > 0; --i) {
+        addLeadingZeroes(ans, chunks[i - 1], false);
     }
     return ans;
 }
 
-void BigInteger::addLeadingZeroes(std::string& str, long long digit,
+void BigInteger::addLeadingZeroes(std::string& str, Limb digit,
                                   bool is_first_digit) {
     size_t zero_count = kBIBaseSize_;
     if (is_first_digit) {
@@ -280,11 +420,7 @@ void BigInteger::addLeadingZeroes(std::string& str, long long digit,
     }
 }
 
-long long BigInteger::moduloBase(long long num) {
-    return num % kBIBase_ < 0 ? num % kBIBase_ + kBIBase_ : num % kBIBase_;
-}
-
-size_t BigInteger::getNumeralLen(long long num) {
+size_t BigInteger::getNumeralLen(Limb num) {
     if (num == 0) {
         return 1;
     }
@@ -304,13 +440,38 @@ BigInteger operator+(BigInteger num1, const BigInteger& num2) {
     num1 += num2;
     return num1;
 }
+BigInteger operator+(const BigInteger& num1, BigInteger&& num2) {
+    num2 += num1;
+    return std::move(num2);
+}
+BigInteger operator+(BigInteger&& num1, BigInteger&& num2) {
+    if (num2.digits_.capacity() > num1.digits_.capacity()) {
+        num2 += num1;
+        return std::move(num2);
+    }
+    num1 += num2;
+    return std::move(num1);
+}
 BigInteger operator-(BigInteger num1, const BigInteger& num2) {
     num1 -= num2;
     return num1;
 }
-BigInteger operator*(BigInteger num1, const BigInteger& num2) {
-    num1 *= num2;
-    return num1;
+BigInteger operator-(const BigInteger& num1, BigInteger&& num2) {
+    num2 -= num1;
+    return -std::move(num2);
+}
+BigInteger operator-(BigInteger&& num1, BigInteger&& num2) {
+    if (num2.digits_.capacity() > num1.digits_.capacity()) {
+        num2 -= num1;
+        return -std::move(num2);
+    }
+    num1 -= num2;
+    return std::move(num1);
+}
+BigInteger operator*(const BigInteger& num1, const BigInteger& num2) {
+    BigInteger product;
+    product.assignProduct(num1, num2);
+    return product;
 }
 BigInteger operator/(BigInteger num1, const BigInteger& num2) {
     num1 /= num2;
@@ -322,9 +483,45 @@ BigInteger operator%(BigInteger num1, const BigInteger& num2) {
     return num1;
 }
 
-BigInteger operator"" _bi(unsigned long long num) { return BigInteger(num); }
+BigInteger operator+(BigInteger num1, int64_t num2) {
+    num1 += num2;
+    return num1;
+}
+BigInteger operator+(int64_t num1, BigInteger num2) {
+    num2 += num1;
+    return num2;
+}
+BigInteger operator-(BigInteger num1, int64_t num2) {
+    num1 -= num2;
+    return num1;
+}
+BigInteger operator-(int64_t num1, BigInteger num2) {
+    num2 -= num1;
+    return -std::move(num2);
+}
+BigInteger operator*(BigInteger num1, int64_t num2) {
+    num1 *= num2;
+    return num1;
+}
+BigInteger operator*(int64_t num1, BigInteger num2) {
+    num2 *= num1;
+    return num2;
+}
+BigInteger operator/(BigInteger num1, int64_t num2) {
+    num1 /= num2;
+    return num1;
+}
+BigInteger operator%(BigInteger num1, int64_t num2) {
+    num1 %= num2;
+    return num1;
+}
+
+std::pair<BigInteger, int64_t> divmod(const BigInteger& num1, int64_t num2) {
+    BigInteger quotient = num1;
+    int64_t remainder = quotient.divideByInteger(num2);
+    return {std::move(quotient), remainder};
+}
 
-BigInteger operator"" _bi(const char* num) { return BigInteger(num); }
 
 bool operator<(const BigInteger& num1, const BigInteger& num2) {
     if (num2.isZero()) {
@@ -367,31 +564,71 @@ bool operator>=(const BigInteger& num1, const BigInteger& num2) {
     return num1 > num2 || num1 == num2;
 }
 
+bool operator<(const BigInteger& num1, int64_t num2) {
+    return num1.compareWithInteger(num2) < 0;
+}
+
+bool operator<(int64_t num1, const BigInteger& num2) {
+    return num2.compareWithInteger(num1) > 0;
+}
+
+bool operator>(const BigInteger& num1, int64_t num2) { return num2 < num1; }
+
+bool operator>(int64_t num1, const BigInteger& num2) { return num2 < num1; }
+
+bool operator==(const BigInteger& num1, int64_t num2) {
+    return num1.compareWithInteger(num2) == 0;
+}
+
+bool operator==(int64_t num1, const BigInteger& num2) { return num2 == num1; }
+
+bool operator!=(const BigInteger& num1, int64_t num2) {
+    return !(num1 == num2);
+}
+
+bool operator!=(int64_t num1, const BigInteger& num2) {
+    return !(num2 == num1);
+}
+
+bool operator<=(const BigInteger& num1, int64_t num2) {
+    return !(num2 < num1);
+}
+
+bool operator<=(int64_t num1, const BigInteger& num2) {
+    return !(num2 < num1);
+}
+
+bool operator>=(const BigInteger& num1, int64_t num2) {
+    return !(num1 < num2);
+}
+
+bool operator>=(int64_t num1, const BigInteger& num2) {
+    return !(num1 < num2);
+}
+
 std::ostream& operator<<(std::ostream& out, const BigInteger& num) {
     out << num.toString();
     return out;
 }
 
 std::istream& operator>>(std::istream& in, BigInteger& num) {
-    std::string new_num;
-    char numeral;
-    bool is_negative_ = false;
-    in.get(numeral);
-    while (!isdigit(numeral) && numeral != '-') {
-        in.get(numeral);
-    }
-    if (numeral == '-') {
-        is_negative_ = true;
-        in.get(numeral);
+    std::istream::sentry sentry(in);
+    if (!sentry) {
+        return in;
+    }
+    std::streambuf* buffer = in.rdbuf();
+    bool is_negative = false;
+    if (buffer->sgetc() == '-') {
+        is_negative = true;
+        buffer->sbumpc();
+    }
+    bool at_eof = false;
+    if (BigInteger::readDigits(buffer, is_negative, num, at_eof) == 0) {
+        in.setstate(std::ios::failbit);
     }
-    while (isdigit(numeral) && !iscntrl(numeral) && !isspace(numeral) &&
-           !in.eof()) {
-        new_num.push_back(numeral);
-        in.get(numeral);
+    if (at_eof) {
+        in.setstate(std::ios::eofbit);
     }
-    num = BigInteger(new_num);
-    num.is_negative_ = is_negative_;
-    num.normalizeNum();
     return in;
 }
 
@@ -399,5 +636,5 @@ void setSign(BigInteger& num, bool is_positive) {
     if ((num > 0) == is_positive) {
         return;
     }
-    num *= BigInteger(-1);
+    num *= -1;
 }
@@ -0,0 +1,118 @@
+#include <utility>
+
+#include "LimbArithmetic.h"
+
+std::pair<BigInteger, BigInteger> divmod(const BigInteger& num1,
+                                         const BigInteger& num2) {
+    BigInteger quotient;
+    BigInteger remainder;
+    if (num1.absoluteComparison(num2) < 0) {
+        remainder = num1;
+        return {std::move(quotient), std::move(remainder)};
+    }
+    quotient.digits_.assign(num1.len() - num2.len() + 1, 0);
+    remainder.digits_.assign(num2.len(), 0);
+    BigInteger::divideLimbs(num1.digits_.data(), num1.len(),
+                            num2.digits_.data(), num2.len(),
+                            quotient.digits_.data(), remainder.digits_.data());
+    quotient.is_negative_ = num1.is_negative_ != num2.is_negative_;
+    remainder.is_negative_ = num1.is_negative_;
+    quotient.normalizeNum();
+    remainder.normalizeNum();
+    return {std::move(quotient), std::move(remainder)};
+}
+
+// Knuth's Algorithm D. Expects len1 >= len2 and a nonzero top limb in
+// the divider; the quotient has len1 - len2 + 1 limbs and the remainder
+// has len2 limbs.
+void BigInteger::divideLimbs(const Limb* num1, size_t len1, const Limb* num2,
+                             size_t len2, Limb* quotient, Limb* remainder) {
+    if (len2 == 1) {
+        DoubleLimb cur_remainder = 0;
+        for (size_t i = len1; i > 0; --i) {
+            DoubleLimb cur_digit = cur_remainder * kBIBase_ + num1[i - 1];
+            quotient[i - 1] = static_cast<Limb>(cur_digit / num2[0]);
+            cur_remainder = cur_digit % num2[0];
+        }
+        remainder[0] = static_cast<Limb>(cur_remainder);
+        return;
+    }
+
+    Limb scale =
+        static_cast<Limb>(kBIBase_ / (DoubleLimb(num2[len2 - 1]) + 1));
+    LimbVector dividend(len1 + 1, 0);
+    LimbVector divider(len2 + 1, 0);
+    multiplySchoolbook(num1, len1, &scale, 1, dividend.data());
+    multiplySchoolbook(num2, len2, &scale, 1, divider.data());
+
+    Limb top = divider[len2 - 1];
+    Limb second = divider[len2 - 2];
+    for (size_t j = len1 - len2 + 1; j > 0; --j) {
+        Limb* window = dividend.data() + j - 1;
+        DoubleLimb head = DoubleLimb(window[len2]) * kBIBase_ + window[len2 - 1];
+        DoubleLimb digit = head / top;
+        DoubleLimb digit_remainder = head % top;
+        while (digit >= kBIBase_ ||
+               digit * second > digit_remainder * kBIBase_ + window[len2 - 2]) {
+            --digit;
+            digit_remainder += top;
+            if (digit_remainder >= kBIBase_) {
+                break;
+            }
+        }
+
+        Limb carry = 0;
+        Limb loan = 0;
+        for (size_t i = 0; i < len2; ++i) {
+            Limb product =
+                multiplyAdd(static_cast<Limb>(digit), divider[i], 0, carry);
+            window[i] = subtractWithLoan(window[i], product, loan);
+        }
+        if (window[len2] < DoubleLimb(carry) + loan) {
+            --digit;
+            addLimbs(window, len2, divider.data(), len2);
+        }
+        window[len2] = 0;
+        quotient[j - 1] = static_cast<Limb>(digit);
+    }
+
+    DoubleLimb cur_remainder = 0;
+    for (size_t i = len2; i > 0; --i) {
+        DoubleLimb cur_digit = cur_remainder * kBIBase_ + dividend[i - 1];
+        remainder[i - 1] = static_cast<Limb>(cur_digit / scale);
+        cur_remainder = cur_digit % scale;
+    }
+}
+
+// Returns floor(kBIBase_^(2n) / num) for a positive num of n limbs. The
+// reciprocal of the top half of num is lifted with one Newton step, which
+// leaves an error of a few units that the final loops remove.
+BigInteger BigInteger::reciprocal(const BigInteger& num) {
+    size_t num_len = num.len();
+    BigInteger power = 1;
+    power.shiftLimbsLeft(2 * num_len);
+    if (num_len <= kReciprocalThreshold_) {
+        return divmod(power, num).first;
+    }
+
+    size_t high_len = num_len / 2 + 2;
+    BigInteger high = num;
+    high.shiftLimbsRight(num_len - high_len);
+    BigInteger result = reciprocal(high);
+    result.shiftLimbsLeft(num_len - high_len);
+
+    BigInteger correction = result * (power - num * result);
+    correction.shiftLimbsRight(2 * num_len);
+    result += correction;
+
+    BigInteger remainder = power - num * result;
+    while (remainder < 0) {
+        --result;
+        remainder += num;
+    }
+    while (remainder >= num) {
+        ++result;
+        remainder -= num;
+    }
+    return result;
+}
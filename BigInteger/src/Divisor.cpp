@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "BigIntegerModular.h"
+#include "LimbArithmetic.h"
+
+BigInteger::Divisor::Divisor(const BigInteger& divisor)
+    : divisor_(divisor), magnitude_(divisor) {
+    if (divisor.isZero()) {
+        throw std::invalid_argument("Divisor must be nonzero");
+    }
+    magnitude_.is_negative_ = false;
+    if (magnitude_.len() >= kBarrettThreshold_) {
+        reciprocal_ = reciprocal(magnitude_);
+    }
+}
+
+const BigInteger& BigInteger::Divisor::divisor() const { return divisor_; }
+
+std::pair<BigInteger, BigInteger> BigInteger::Divisor::divmod(
+    const BigInteger& num) const {
+    if (reciprocal_.isZero()) {
+        return ::divmod(num, divisor_);
+    }
+    BigInteger quotient;
+    BigInteger remainder;
+    divideMagnitude(num, &quotient, remainder);
+    quotient.is_negative_ = num.is_negative_ != divisor_.is_negative_;
+    quotient.normalizeNum();
+    return {std::move(quotient), std::move(remainder)};
+}
+
+BigInteger BigInteger::Divisor::reduce(const BigInteger& num) const {
+    if (reciprocal_.isZero()) {
+        return num % divisor_;
+    }
+    BigInteger remainder;
+    divideMagnitude(num, nullptr, remainder);
+    return remainder;
+}
+
+BigInteger BigInteger::Divisor::mulmod(const BigInteger& num1,
+                                       const BigInteger& num2) const {
+    BigInteger product;
+    product.assignProduct(num1, num2);
+    if (reciprocal_.isZero()) {
+        product %= divisor_;
+        return product;
+    }
+    BigInteger remainder;
+    divideMagnitude(product, nullptr, remainder);
+    return remainder;
+}
+
+// Schoolbook division in base kBIBase_^n: every block of n limbs, with
+// the running remainder on top, is below magnitude_ * kBIBase_^n. The
+// remainder takes the sign of num; the quotient is left nonnegative.
+void BigInteger::Divisor::divideMagnitude(const BigInteger& num,
+                                          BigInteger* quotient,
+                                          BigInteger& remainder) const {
+    size_t block_len = magnitude_.len();
+    size_t num_len = num.len();
+    size_t block_count = (num_len + block_len - 1) / block_len;
+    if (quotient != nullptr) {
+        quotient->digits_.assign(block_count * block_len, 0);
+        quotient->is_negative_ = false;
+    }
+    remainder = 0;
+    BigInteger current;
+    BigInteger block_quotient;
+    for (size_t block = block_count; block > 0; --block) {
+        size_t start = (block - 1) * block_len;
+        size_t end = std::min(start + block_len, num_len);
+        current.digits_.assign(num.digits_.data() + start,
+                               num.digits_.data() + end);
+        if (!remainder.isZero()) {
+            current.digits_.resize(block_len + remainder.len(), 0);
+            std::copy(remainder.digits_.begin(), remainder.digits_.end(),
+                      current.digits_.begin() + block_len);
+        }
+        current.is_negative_ = false;
+        current.normalizeNum();
+        divideBlock(current, block_quotient, remainder);
+        if (quotient != nullptr) {
+            std::copy(block_quotient.digits_.begin(),
+                      block_quotient.digits_.end(),
+                      quotient->digits_.begin() + start);
+        }
+    }
+    if (quotient != nullptr) {
+        quotient->normalizeNum();
+    }
+    remainder.is_negative_ = num.is_negative_;
+    remainder.normalizeNum();
+}
+
+// One Barrett step for a nonnegative num below magnitude_ * kBIBase_^n.
+// The estimate drops the low n - 1 limbs of num and the low n + 1 limbs
+// of the product with mu, which makes it short by at most two.
+void BigInteger::Divisor::divideBlock(const BigInteger& num,
+                                      BigInteger& quotient,
+                                      BigInteger& remainder) const {
+    size_t len = magnitude_.len();
+    if (num.absoluteComparison(magnitude_) < 0) {
+        quotient = 0;
+        remainder = num;
+        return;
+    }
+    BigInteger top = fromLimbs(num.digits_.data() + len - 1,
+                               num.len() - len + 1);
+    quotient.assignProduct(top, reciprocal_);
+    quotient.shiftLimbsRight(len + 1);
+    BigInteger product;
+    product.assignProduct(quotient, magnitude_);
+    remainder = num;
+    remainder -= product;
+    while (remainder.absoluteComparison(magnitude_) >= 0) {
+        remainder -= magnitude_;
+        ++quotient;
+    }
+}
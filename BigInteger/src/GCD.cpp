@@ -0,0 +1,166 @@
+#include <utility>
+
+#include "LimbArithmetic.h"
+
+namespace {
+  // Replaces (first, second) with (a * first + b * second,
+  // c * first + d * second) for cofactors {a, b, c, d}.
+  void applyCofactors(BigInteger& first, BigInteger& second,
+                      const int64_t* cofactors, BigInteger& next,
+                      BigInteger& scratch) {
+    next = first;
+    next *= cofactors[0];
+    scratch = second;
+    scratch *= cofactors[1];
+    next += scratch;
+    scratch = first;
+    scratch *= cofactors[2];
+    second *= cofactors[3];
+    second += scratch;
+    std::swap(first, next);
+  }
+}
+
+// Lehmer's GCD: the leading two limbs of both numbers, scaled below 2^62,
+// drive Euclid's algorithm in machine words until a quotient becomes
+// uncertain, and the accumulated cofactors are then applied to the full
+// numbers at once. Single-limb tails finish with the binary GCD.
+BigInteger gcd(const BigInteger& num1, const BigInteger& num2) {
+    BigInteger first = num1;
+    BigInteger second = num2;
+    first.is_negative_ = false;
+    second.is_negative_ = false;
+    if (first.absoluteComparison(second) < 0) {
+        std::swap(first, second);
+    }
+    BigInteger next;
+    BigInteger scratch;
+    int64_t cofactors[4];
+    while (second.len() > 1) {
+        if (BigInteger::lehmerCofactors(first, second, cofactors)) {
+            applyCofactors(first, second, cofactors, next, scratch);
+        } else {
+            first %= second;
+            std::swap(first, second);
+        }
+    }
+    if (second.isZero()) {
+        return first;
+    }
+    first %= second;
+    return BigInteger::binaryGcd(first.digits_[0], second.digits_[0]);
+}
+
+// Runs the same Lehmer steps while tracking the coefficient of the larger
+// input only; the other one is recovered by an exact division at the end.
+std::tuple<BigInteger, BigInteger, BigInteger> extendedGcd(
+    const BigInteger& num1, const BigInteger& num2) {
+    BigInteger first = num1;
+    BigInteger second = num2;
+    first.is_negative_ = false;
+    second.is_negative_ = false;
+    bool swapped = first.absoluteComparison(second) < 0;
+    if (swapped) {
+        std::swap(first, second);
+    }
+    BigInteger larger = first;
+    BigInteger smaller = second;
+    BigInteger first_coef = 1;
+    BigInteger second_coef = 0;
+    BigInteger next;
+    BigInteger scratch;
+    int64_t cofactors[4];
+    while (!second.isZero()) {
+        if (second.len() > 1 &&
+            BigInteger::lehmerCofactors(first, second, cofactors)) {
+            applyCofactors(first, second, cofactors, next, scratch);
+            applyCofactors(first_coef, second_coef, cofactors, next, scratch);
+        } else {
+            auto [quotient, remainder] = divmod(first, second);
+            first = std::move(second);
+            second = std::move(remainder);
+            first_coef -= quotient * second_coef;
+            std::swap(first_coef, second_coef);
+        }
+    }
+
+    BigInteger larger_coef = std::move(first_coef);
+    BigInteger smaller_coef;
+    if (!smaller.isZero()) {
+        smaller_coef = (first - larger * larger_coef) / smaller;
+    }
+    if (swapped) {
+        std::swap(larger_coef, smaller_coef);
+    }
+    if (num1.is_negative_) {
+        larger_coef = -std::move(larger_coef);
+    }
+    if (num2.is_negative_) {
+        smaller_coef = -std::move(smaller_coef);
+    }
+    return {std::move(first), std::move(larger_coef),
+            std::move(smaller_coef)};
+}
+
+// Knuth's Algorithm L step for first >= second, second of at least two
+// limbs. Fills {a, b, c, d} and returns false when not even the first
+// quotient is certain, in which case a full division step is needed.
+bool BigInteger::lehmerCofactors(const BigInteger& first,
+                                 const BigInteger& second,
+                                 int64_t* cofactors) {
+    size_t len = first.len();
+    auto leading = [len](const BigInteger& num) {
+        DoubleLimb high = num.len() >= len ? num.digits_[len - 1] : 0;
+        DoubleLimb low = num.len() >= len - 1 ? num.digits_[len - 2] : 0;
+        return high * kBIBase_ + low;
+    };
+    DoubleLimb first_head = leading(first);
+    DoubleLimb second_head = leading(second);
+    while (first_head >= DoubleLimb(1) << 62) {
+        first_head >>= 1;
+        second_head >>= 1;
+    }
+
+    int64_t x = static_cast<int64_t>(first_head);
+    int64_t y = static_cast<int64_t>(second_head);
+    int64_t a = 1;
+    int64_t b = 0;
+    int64_t c = 0;
+    int64_t d = 1;
+    while (y + c != 0 && y + d != 0) {
+        int64_t quotient = (x + a) / (y + c);
+        if (quotient != (x + b) / (y + d)) {
+            break;
+        }
+        int64_t next = a - quotient * c;
+        a = c;
+        c = next;
+        next = b - quotient * d;
+        b = d;
+        d = next;
+        next = x - quotient * y;
+        x = y;
+        y = next;
+    }
+    cofactors[0] = a;
+    cofactors[1] = b;
+    cofactors[2] = c;
+    cofactors[3] = d;
+    return b != 0;
+}
+
+BigInteger::Limb BigInteger::binaryGcd(Limb num1, Limb num2) {
+    if (num1 == 0 || num2 == 0) {
+        return num1 | num2;
+    }
+    int shift = __builtin_ctzll(num1 | num2);
+    num1 >>= __builtin_ctzll(num1);
+    while (num2 != 0) {
+        num2 >>= __builtin_ctzll(num2);
+        if (num1 > num2) {
+            std::swap(num1, num2);
+        }
+        num2 -= num1;
+    }
+    return num1 << shift;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include "BigInteger.h"
+
+inline BigInteger::Limb BigInteger::addWithCarry(Limb num1, Limb num2,
+                                                 Limb& carry) {
+    DoubleLimb sum = DoubleLimb(num1) + num2 + carry;
+    carry = sum >= kBIBase_ ? 1 : 0;
+    return static_cast<Limb>(sum - carry * kBIBase_);
+}
+
+inline BigInteger::Limb BigInteger::subtractWithLoan(Limb num1, Limb num2,
+                                                     Limb& loan) {
+    DoubleLimb subtrahend = DoubleLimb(num2) + loan;
+    loan = num1 < subtrahend ? 1 : 0;
+    return static_cast<Limb>(num1 + loan * kBIBase_ - subtrahend);
+}
+
+inline BigInteger::Limb BigInteger::multiplyAdd(Limb num1, Limb num2,
+                                                Limb addend, Limb& carry) {
+    DoubleLimb product = DoubleLimb(num1) * num2 + addend + carry;
+    carry = static_cast<Limb>(product / kBIBase_);
+    return static_cast<Limb>(product % kBIBase_);
+}
+
+// Runs every task once. For products of at least kParallelThreshold_
+// limbs all tasks but the first go to extra threads while the budget
+// set by setThreadCount lasts; the rest run here. Tasks must write to
+// disjoint memory. The first exception thrown by a task is rethrown
+// after all of them have finished.
+template <typename... Tasks>
+void BigInteger::runTasks(size_t len, Tasks&&... tasks) {
+    if (len < kParallelThreshold_ || threadCount() <= 1) {
+        (tasks(), ...);
+        return;
+    }
+    constexpr size_t kCount = sizeof...(Tasks);
+    bool spawned[kCount] = {};
+    std::exception_ptr errors[kCount];
+    std::vector<std::thread> workers;
+    workers.reserve(kCount);
+    size_t index = 0;
+    auto spawn = [&](auto& task) {
+        size_t i = index++;
+        if (i == 0 || !reserveThread()) {
+            return;
+        }
+        try {
+            workers.emplace_back([&task, &error = errors[i]] {
+                try {
+                    task();
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                releaseThread();
+            });
+            spawned[i] = true;
+        } catch (...) {
+            releaseThread();
+        }
+    };
+    (spawn(tasks), ...);
+
+    index = 0;
+    auto run = [&](auto& task) {
+        size_t i = index++;
+        if (spawned[i]) {
+            return;
+        }
+        try {
+            task();
+        } catch (...) {
+            errors[i] = std::current_exception();
+        }
+    };
+    (run(tasks), ...);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
@@ -0,0 +1,179 @@
+#include "Matrix.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include "BigIntegerModular.h"
+
+namespace {
+  const size_t kMinRowsPerThread = 4;
+
+  // Calls body(i) for every i in [begin, end), splitting the range into
+  // contiguous chunks that run on up to threads threads.
+  template <typename Body>
+  void parallelFor(size_t begin, size_t end, size_t threads, Body body) {
+    size_t count = end > begin ? end - begin : 0;
+    threads = std::min(threads, count / kMinRowsPerThread);
+    if (threads <= 1) {
+        for (size_t i = begin; i < end; ++i) {
+            body(i);
+        }
+        return;
+    }
+    size_t chunk = (count + threads - 1) / threads;
+    auto run = [end, chunk, &body](size_t start) {
+        for (size_t i = start; i < std::min(start + chunk, end); ++i) {
+            body(i);
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t start = begin + chunk; start < end; start += chunk) {
+        workers.emplace_back(run, start);
+    }
+    run(begin);
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+  }
+}
+
+Matrix::Matrix(size_t rows, size_t columns)
+    : rows_(rows), columns_(columns), entries_(rows * columns) {}
+
+Matrix::Matrix(
+    std::initializer_list<std::initializer_list<BigInteger>> entries)
+    : rows_(entries.size()),
+      columns_(entries.size() == 0 ? 0 : entries.begin()->size()) {
+    entries_.reserve(rows_ * columns_);
+    for (const auto& row : entries) {
+        if (row.size() != columns_) {
+            throw std::invalid_argument("Matrix rows must have equal length");
+        }
+        entries_.insert(entries_.end(), row.begin(), row.end());
+    }
+}
+
+size_t Matrix::rows() const { return rows_; }
+
+size_t Matrix::columns() const { return columns_; }
+
+BigInteger& Matrix::operator()(size_t row, size_t column) {
+    return entries_[row * columns_ + column];
+}
+
+const BigInteger& Matrix::operator()(size_t row, size_t column) const {
+    return entries_[row * columns_ + column];
+}
+
+BigInteger Matrix::determinant(size_t threads) const {
+    if (rows_ != columns_) {
+        throw std::invalid_argument("Determinant needs a square matrix");
+    }
+    if (rows_ == 0) {
+        return 1;
+    }
+    Matrix reduced = *this;
+    bool negated = false;
+    if (reduced.eliminate(columns_, true, negated, threads) < rows_) {
+        return 0;
+    }
+    BigInteger result = std::move(reduced(rows_ - 1, columns_ - 1));
+    return negated ? -std::move(result) : result;
+}
+
+size_t Matrix::rank(size_t threads) const {
+    Matrix reduced = *this;
+    bool negated = false;
+    return reduced.eliminate(columns_, false, negated, threads);
+}
+
+// After elimination of [A | b] the last pivot d is det A up to sign, and
+// y = d x is integral by Cramer's rule, so back substitution on y only
+// needs exact divisions.
+std::vector<Rational> Matrix::solve(const std::vector<BigInteger>& rhs,
+                                    size_t threads) const {
+    if (rows_ != columns_ || rhs.size() != rows_) {
+        throw std::invalid_argument("solve needs a square system");
+    }
+    size_t size = rows_;
+    Matrix augmented(size, size + 1);
+    for (size_t row = 0; row < size; ++row) {
+        std::copy(entries_.begin() + row * size,
+                  entries_.begin() + (row + 1) * size,
+                  augmented.entries_.begin() + row * (size + 1));
+        augmented(row, size) = rhs[row];
+    }
+    bool negated = false;
+    if (augmented.eliminate(size, true, negated, threads) < size) {
+        throw std::invalid_argument("Matrix is singular");
+    }
+    if (size == 0) {
+        return {};
+    }
+
+    const BigInteger& pivot = augmented(size - 1, size - 1);
+    std::vector<BigInteger> scaled(size);
+    for (size_t row = size; row > 0; --row) {
+        size_t i = row - 1;
+        BigInteger value = pivot * augmented(i, size);
+        for (size_t j = i + 1; j < size; ++j) {
+            value -= augmented(i, j) * scaled[j];
+        }
+        scaled[i] = value / augmented(i, i);
+    }
+    std::vector<Rational> solution;
+    solution.reserve(size);
+    for (const BigInteger& value : scaled) {
+        solution.emplace_back(value, pivot);
+    }
+    return solution;
+}
+
+// Bareiss step for pivot p in row r and column c:
+// a[i][j] = (p * a[i][j] - a[i][c] * a[r][j]) / previous pivot for i > r.
+size_t Matrix::eliminate(size_t pivot_columns, bool full_rank, bool& negated,
+                         size_t threads) {
+    negated = false;
+    BigInteger previous = 1;
+    size_t rank = 0;
+    for (size_t column = 0; column < pivot_columns && rank < rows_;
+         ++column) {
+        size_t pivot_row = rank;
+        while (pivot_row < rows_ && !(*this)(pivot_row, column)) {
+            ++pivot_row;
+        }
+        if (pivot_row == rows_) {
+            if (full_rank) {
+                return rank;
+            }
+            continue;
+        }
+        if (pivot_row != rank) {
+            std::swap_ranges(entries_.begin() + pivot_row * columns_,
+                             entries_.begin() + (pivot_row + 1) * columns_,
+                             entries_.begin() + rank * columns_);
+            negated = !negated;
+        }
+
+        const BigInteger& pivot = (*this)(rank, column);
+        bool divide = previous != 1;
+        BigInteger::Divisor divisor(previous);
+        parallelFor(rank + 1, rows_, threads, [&](size_t row) {
+            BigInteger& factor = (*this)(row, column);
+            for (size_t j = column + 1; j < columns_; ++j) {
+                BigInteger& entry = (*this)(row, j);
+                entry *= pivot;
+                entry -= factor * (*this)(rank, j);
+                if (divide) {
+                    entry = divisor.divmod(entry).first;
+                }
+            }
+            factor = 0;
+        });
+        previous = pivot;
+        ++rank;
+    }
+    return rank;
+}
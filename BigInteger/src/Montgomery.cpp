@@ -0,0 +1,237 @@
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "BigIntegerModular.h"
+#include "LimbArithmetic.h"
+
+namespace {
+  constexpr int64_t kBitChunk = int64_t(1) << 30;
+  constexpr size_t kBitChunkSize = 30;
+
+  // Binary digits of a nonnegative num, least significant first.
+  std::vector<bool> binaryDigits(BigInteger num) {
+    if (num < 0) {
+        throw std::invalid_argument("Exponent must be nonnegative");
+    }
+    std::vector<bool> bits;
+    while (num) {
+        auto [quotient, chunk] = divmod(num, kBitChunk);
+        for (size_t i = 0; i < kBitChunkSize; ++i) {
+            bits.push_back((chunk >> i) & 1);
+        }
+        num = std::move(quotient);
+    }
+    while (!bits.empty() && !bits.back()) {
+        bits.pop_back();
+    }
+    return bits;
+  }
+
+  size_t windowSize(size_t bit_count) {
+    size_t size = 1;
+    for (size_t bound : {24, 80, 240, 672}) {
+        if (bit_count > bound) {
+            ++size;
+        }
+    }
+    return size;
+  }
+
+  // Left-to-right sliding-window exponentiation over the odd powers of
+  // base. multiply(result, num1, num2) stores the product into a result
+  // that aliases neither factor.
+  template <typename Multiply>
+  BigInteger slidingWindowPow(const BigInteger& base, const BigInteger& one,
+                              const std::vector<bool>& bits,
+                              Multiply multiply) {
+    if (bits.empty()) {
+        return one;
+    }
+    size_t window = windowSize(bits.size());
+    std::vector<BigInteger> odd_powers(size_t(1) << (window - 1));
+    odd_powers[0] = base;
+    BigInteger square;
+    multiply(square, base, base);
+    for (size_t i = 1; i < odd_powers.size(); ++i) {
+        multiply(odd_powers[i], odd_powers[i - 1], square);
+    }
+
+    BigInteger result;
+    BigInteger scratch;
+    bool started = false;
+    for (size_t end = bits.size(); end > 0;) {
+        if (!bits[end - 1]) {
+            multiply(scratch, result, result);
+            std::swap(result, scratch);
+            --end;
+            continue;
+        }
+        size_t start = end > window ? end - window : 0;
+        while (!bits[start]) {
+            ++start;
+        }
+        size_t value = 0;
+        for (size_t i = end; i > start; --i) {
+            value = 2 * value + bits[i - 1];
+            if (started) {
+                multiply(scratch, result, result);
+                std::swap(result, scratch);
+            }
+        }
+        if (started) {
+            multiply(scratch, result, odd_powers[value / 2]);
+            std::swap(result, scratch);
+        } else {
+            result = odd_powers[value / 2];
+            started = true;
+        }
+        end = start;
+    }
+    return result;
+  }
+}
+
+BigInteger::Montgomery::Montgomery(const BigInteger& modulus)
+    : modulus_(modulus) {
+    if (!isSupported(modulus)) {
+        throw std::invalid_argument(
+            "Montgomery modulus must be positive and coprime to the base");
+    }
+    size_t modulus_len = modulus_.len();
+    inverse_ = negatedInverse(modulus_.digits_[0]);
+    one_ = 1;
+    one_.shiftLimbsLeft(modulus_len);
+    one_ %= modulus_;
+    r_squared_ = 1;
+    r_squared_.shiftLimbsLeft(2 * modulus_len);
+    r_squared_ %= modulus_;
+}
+
+bool BigInteger::Montgomery::isSupported(const BigInteger& modulus) {
+    Limb lowest = modulus.digits_[0];
+    return modulus > 0 && lowest % 2 != 0 &&
+           (kBIBase_ % 5 != 0 || lowest % 5 != 0);
+}
+
+const BigInteger& BigInteger::Montgomery::modulus() const { return modulus_; }
+
+BigInteger BigInteger::Montgomery::toMontgomery(const BigInteger& num) const {
+    BigInteger residue = num;
+    if (residue.absoluteComparison(modulus_) >= 0) {
+        residue %= modulus_;
+    }
+    if (residue.is_negative_) {
+        residue += modulus_;
+    }
+    return multiply(residue, r_squared_);
+}
+
+BigInteger BigInteger::Montgomery::fromMontgomery(const BigInteger& num) const {
+    LimbVector product(2 * modulus_.len() + 1, 0);
+    std::copy(num.digits_.begin(), num.digits_.end(), product.begin());
+    BigInteger result;
+    reduce(product, result);
+    return result;
+}
+
+BigInteger BigInteger::Montgomery::multiply(const BigInteger& num1,
+                                            const BigInteger& num2) const {
+    BigInteger result;
+    LimbVector product;
+    multiplyInto(result, num1, num2, product);
+    return result;
+}
+
+BigInteger BigInteger::Montgomery::pow(const BigInteger& base,
+                                       const BigInteger& exp) const {
+    std::vector<bool> bits = binaryDigits(exp);
+    LimbVector product;
+    BigInteger power = slidingWindowPow(
+        toMontgomery(base), one_, bits,
+        [this, &product](BigInteger& result, const BigInteger& num1,
+                         const BigInteger& num2) {
+            multiplyInto(result, num1, num2, product);
+        });
+    return fromMontgomery(power);
+}
+
+// Both factors are residues below the modulus; product is scratch space
+// that keeps its capacity between calls.
+void BigInteger::Montgomery::multiplyInto(BigInteger& result,
+                                          const BigInteger& num1,
+                                          const BigInteger& num2,
+                                          LimbVector& product) const {
+    product.assign(2 * modulus_.len() + 1, 0);
+    multiplyLimbs(num1.digits_.data(), num1.len(), num2.digits_.data(),
+                  num2.len(), product.data());
+    reduce(product, result);
+}
+
+// REDC: stores product / R mod m into result for a product of 2n + 1
+// limbs below m * R.
+void BigInteger::Montgomery::reduce(LimbVector& product,
+                                    BigInteger& result) const {
+    size_t modulus_len = modulus_.len();
+    const Limb* modulus = modulus_.digits_.data();
+    for (size_t i = 0; i < modulus_len; ++i) {
+        Limb carry = 0;
+        Limb factor = multiplyAdd(product[i], inverse_, 0, carry);
+        carry = 0;
+        for (size_t j = 0; j < modulus_len; ++j) {
+            product[i + j] =
+                multiplyAdd(modulus[j], factor, product[i + j], carry);
+        }
+        addLimbs(product.data() + i + modulus_len, modulus_len + 1 - i,
+                 &carry, 1);
+    }
+    result.digits_.assign(product.data() + modulus_len,
+                          product.data() + 2 * modulus_len + 1);
+    result.is_negative_ = false;
+    result.normalizeNum();
+    if (result.absoluteComparison(modulus_) >= 0) {
+        result.absoluteSubtraction(modulus_);
+    }
+}
+
+// Returns -num^(-1) mod kBIBase_. An inverse modulo the product of the
+// primes dividing the base (2 or 10) is lifted by Newton steps, each of
+// which doubles the number of correct digits.
+BigInteger::Limb BigInteger::Montgomery::negatedInverse(Limb num) {
+    DoubleLimb radical = kBIBase_ % 5 == 0 ? 10 : 2;
+    DoubleLimb inverse = 1;
+    while (DoubleLimb(num) * inverse % radical != 1) {
+        ++inverse;
+    }
+    for (DoubleLimb precision = radical; precision < kBIBase_;
+         precision *= precision) {
+        DoubleLimb product = DoubleLimb(num) * inverse % kBIBase_;
+        inverse = inverse * ((kBIBase_ + 2 - product) % kBIBase_) % kBIBase_;
+    }
+    return static_cast<Limb>((kBIBase_ - inverse) % kBIBase_);
+}
+
+BigInteger BigInteger::powMod(const BigInteger& base, const BigInteger& exp,
+                              const BigInteger& mod) {
+    if (mod <= 0) {
+        throw std::invalid_argument("Modulus must be positive");
+    }
+    if (Montgomery::isSupported(mod)) {
+        return Montgomery(mod).pow(base, exp);
+    }
+
+    // Moduli that share a factor with the base are reduced by a Barrett
+    // divisor instead.
+    std::vector<bool> bits = binaryDigits(exp);
+    Divisor divisor(mod);
+    BigInteger residue = divisor.reduce(base);
+    if (residue < 0) {
+        residue += mod;
+    }
+    return slidingWindowPow(
+        residue, 1 % mod, bits,
+        [&divisor](BigInteger& result, const BigInteger& num1,
+                   const BigInteger& num2) {
+            result = divisor.mulmod(num1, num2);
+        });
+}
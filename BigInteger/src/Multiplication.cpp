@@ -0,0 +1,364 @@
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "LimbArithmetic.h"
+
+namespace {
+  std::atomic<size_t> thread_count{1};
+  // Threads started by runTasks that have not finished yet.
+  std::atomic<size_t> extra_threads{0};
+}
+
+void BigInteger::setThreadCount(size_t count) {
+    thread_count = std::max<size_t>(count, 1);
+}
+
+size_t BigInteger::threadCount() { return thread_count; }
+
+bool BigInteger::reserveThread() {
+    size_t running = extra_threads;
+    while (running + 1 < thread_count) {
+        if (extra_threads.compare_exchange_weak(running, running + 1)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void BigInteger::releaseThread() { --extra_threads; }
+
+BigInteger BigInteger::fromLimbs(const Limb* limbs, size_t count) {
+    BigInteger num;
+    if (count > 0) {
+        num.digits_.assign(limbs, limbs + count);
+    }
+    num.normalizeNum();
+    return num;
+}
+
+void BigInteger::multiplyBySmall(Limb multiplier) {
+    Limb carry = 0;
+    for (Limb& digit : digits_) {
+        digit = multiplyAdd(digit, multiplier, 0, carry);
+    }
+    if (carry != 0) {
+        digits_.push_back(carry);
+    }
+    normalizeNum();
+}
+
+BigInteger::Limb BigInteger::divideBySmall(Limb divider) {
+    DoubleLimb remainder = 0;
+    for (size_t i = len(); i > 0; --i) {
+        DoubleLimb cur_digit = remainder * kBIBase_ + digits_[i - 1];
+        digits_[i - 1] = static_cast<Limb>(cur_digit / divider);
+        remainder = cur_digit % divider;
+    }
+    normalizeNum();
+    return static_cast<Limb>(remainder);
+}
+
+BigInteger::Limb BigInteger::addLimbs(Limb* dst, size_t dst_len,
+                                      const Limb* src, size_t src_len) {
+    Limb carry = 0;
+    size_t i = 0;
+    if (src_len >= kVectorThreshold_ && hasVectorKernels()) {
+        carry = addLimbsVector(dst, src, src_len, carry);
+        i = src_len;
+    }
+    for (; i < src_len; ++i) {
+        dst[i] = addWithCarry(dst[i], src[i], carry);
+    }
+    for (; carry != 0 && i < dst_len; ++i) {
+        dst[i] = addWithCarry(dst[i], 0, carry);
+    }
+    return carry;
+}
+
+void BigInteger::subtractLimbs(Limb* dst, size_t dst_len, const Limb* src,
+                               size_t src_len) {
+    Limb loan = 0;
+    size_t i = 0;
+    if (src_len >= kVectorThreshold_ && hasVectorKernels()) {
+        loan = subtractLimbsVector(dst, dst, src, src_len, loan);
+        i = src_len;
+    }
+    for (; i < src_len; ++i) {
+        dst[i] = subtractWithLoan(dst[i], src[i], loan);
+    }
+    for (; loan != 0 && i < dst_len; ++i) {
+        dst[i] = subtractWithLoan(dst[i], 0, loan);
+    }
+}
+
+// Stores |src| - |dst| into dst, both of len limbs, for |src| >= |dst|.
+void BigInteger::subtractFromLimbs(Limb* dst, const Limb* src, size_t len) {
+    if (len >= kVectorThreshold_ && hasVectorKernels()) {
+        subtractLimbsVector(dst, src, dst, len, 0);
+        return;
+    }
+    Limb loan = 0;
+    for (size_t i = 0; i < len; ++i) {
+        dst[i] = subtractWithLoan(src[i], dst[i], loan);
+    }
+}
+
+// Writes the product into this number's storage, reusing its capacity.
+// Neither factor may alias this number.
+void BigInteger::assignProduct(const BigInteger& num1, const BigInteger& num2) {
+    digits_.assign(num1.len() + num2.len(), 0);
+    multiplyLimbs(num1.digits_.data(), num1.len(), num2.digits_.data(),
+                  num2.len(), digits_.data());
+    is_negative_ = num1.is_negative_ != num2.is_negative_;
+    normalizeNum();
+}
+
+// Adds (or subtracts) num1 * num2 to this number. When the product has the
+// same sign as the accumulator, short rows are multiplied straight into
+// its limbs; otherwise the product goes through scratch. Neither factor
+// may alias this number.
+void BigInteger::addProduct(const BigInteger& num1, const BigInteger& num2,
+                            bool subtract, BigInteger& scratch) {
+    if (num1.isZero() || num2.isZero()) {
+        return;
+    }
+    bool product_negative =
+        (num1.is_negative_ != num2.is_negative_) != subtract;
+    const BigInteger* longer = &num1;
+    const BigInteger* shorter = &num2;
+    if (longer->len() < shorter->len()) {
+        std::swap(longer, shorter);
+    }
+    if (isZero()) {
+        is_negative_ = product_negative;
+    }
+    if (product_negative != is_negative_ ||
+        shorter->len() >= kKaratsubaThreshold_) {
+        scratch.assignProduct(num1, num2);
+        scratch.is_negative_ = product_negative;
+        *this += scratch;
+        return;
+    }
+
+    size_t longer_len = longer->len();
+    if (len() < longer_len + shorter->len()) {
+        digits_.resize(longer_len + shorter->len(), 0);
+    }
+    Limb overflow = 0;
+    for (size_t i = 0; i < shorter->len(); ++i) {
+        Limb multiplier = shorter->digits_[i];
+        Limb carry = 0;
+        for (size_t j = 0; j < longer_len; ++j) {
+            digits_[i + j] = multiplyAdd(longer->digits_[j], multiplier,
+                                         digits_[i + j], carry);
+        }
+        overflow += addLimbs(digits_.data() + i + longer_len,
+                             len() - i - longer_len, &carry, 1);
+    }
+    if (overflow != 0) {
+        digits_.push_back(overflow);
+    }
+    normalizeNum();
+}
+
+// Adds (or subtracts) num * factor to this number. A factor below the
+// limb base whose product has the sign of the accumulator is multiplied
+// straight into its limbs in one pass; otherwise the product goes through
+// scratch. num may not alias this number.
+void BigInteger::addScaled(const BigInteger& num, int64_t factor,
+                           bool subtract, BigInteger& scratch) {
+    if (factor == 0 || num.isZero()) {
+        return;
+    }
+    uint64_t magnitude = static_cast<uint64_t>(factor);
+    if (factor < 0) {
+        magnitude = 0 - magnitude;
+    }
+    bool product_negative = (num.is_negative_ != (factor < 0)) != subtract;
+    if (isZero()) {
+        is_negative_ = product_negative;
+    }
+    if (product_negative != is_negative_ || magnitude >= kBIBase_) {
+        scratch = num;
+        scratch *= factor;
+        if (subtract) {
+            *this -= scratch;
+        } else {
+            *this += scratch;
+        }
+        return;
+    }
+
+    size_t num_len = num.len();
+    if (len() < num_len + 1) {
+        digits_.resize(num_len + 1, 0);
+    }
+    Limb multiplier = static_cast<Limb>(magnitude);
+    Limb carry = 0;
+    for (size_t i = 0; i < num_len; ++i) {
+        digits_[i] =
+            multiplyAdd(num.digits_[i], multiplier, digits_[i], carry);
+    }
+    Limb overflow =
+        addLimbs(digits_.data() + num_len, len() - num_len, &carry, 1);
+    if (overflow != 0) {
+        digits_.push_back(overflow);
+    }
+    normalizeNum();
+}
+
+// All multiplication kernels expect a zero-filled output of n + m limbs.
+void BigInteger::multiplyLimbs(const Limb* num1, size_t len1,
+                               const Limb* num2, size_t len2, Limb* result) {
+    if (len1 < len2) {
+        std::swap(num1, num2);
+        std::swap(len1, len2);
+    }
+    if (len2 == 0) {
+        return;
+    }
+    if (len2 < kKaratsubaThreshold_) {
+        multiplySchoolbook(num1, len1, num2, len2, result);
+        return;
+    }
+    if (len1 >= 2 * len2) {
+        std::vector<Limb> chunk_product(2 * len2);
+        for (size_t start = 0; start < len1; start += len2) {
+            size_t chunk_len = std::min(len2, len1 - start);
+            std::fill(chunk_product.begin(), chunk_product.end(), 0);
+            multiplyLimbs(num1 + start, chunk_len, num2, len2,
+                          chunk_product.data());
+            addLimbs(result + start, len1 + len2 - start, chunk_product.data(),
+                     chunk_len + len2);
+        }
+        return;
+    }
+    if (len2 < kToomThreshold_) {
+        multiplyKaratsuba(num1, len1, num2, len2, result);
+    } else if (len2 < kNTTThreshold_) {
+        multiplyToom3(num1, len1, num2, len2, result);
+    } else {
+        multiplyLimbsNTT(num1, len1, num2, len2, result);
+    }
+}
+
+void BigInteger::multiplySchoolbook(const Limb* num1, size_t len1,
+                                    const Limb* num2, size_t len2,
+                                    Limb* result) {
+    for (size_t i = 0; i < len2; ++i) {
+        Limb multiplier = num2[i];
+        if (multiplier == 0) {
+            continue;
+        }
+        Limb carry = 0;
+        for (size_t j = 0; j < len1; ++j) {
+            result[i + j] =
+                multiplyAdd(num1[j], multiplier, result[i + j], carry);
+        }
+        result[i + len1] = carry;
+    }
+}
+
+// Expects len1 / 2 < len2 <= len1, which multiplyLimbs guarantees.
+void BigInteger::multiplyKaratsuba(const Limb* num1, size_t len1,
+                                   const Limb* num2, size_t len2,
+                                   Limb* result) {
+    size_t half = len1 / 2;
+    size_t high_len1 = len1 - half;
+    size_t high_len2 = len2 - half;
+    size_t result_len = len1 + len2;
+
+    std::vector<Limb> sum1(num1 + half, num1 + len1);
+    sum1.push_back(0);
+    addLimbs(sum1.data(), sum1.size(), num1, half);
+
+    std::vector<Limb> sum2(num2, num2 + half);
+    sum2.resize(std::max(half, high_len2) + 1, 0);
+    addLimbs(sum2.data(), sum2.size(), num2 + half, high_len2);
+
+    std::vector<Limb> middle(sum1.size() + sum2.size(), 0);
+    runTasks(
+        len2, [&] { multiplyLimbs(num1, half, num2, half, result); },
+        [&] {
+            multiplyLimbs(num1 + half, high_len1, num2 + half, high_len2,
+                          result + 2 * half);
+        },
+        [&] {
+            multiplyLimbs(sum1.data(), sum1.size(), sum2.data(), sum2.size(),
+                          middle.data());
+        });
+    subtractLimbs(middle.data(), middle.size(), result, 2 * half);
+    subtractLimbs(middle.data(), middle.size(), result + 2 * half,
+                  result_len - 2 * half);
+    addLimbs(result + half, result_len - half, middle.data(),
+             std::min(middle.size(), result_len - half));
+}
+
+// Toom-3 with evaluation points 0, 1, -1, -2, inf and Bodrato's
+// interpolation sequence. Expects len1 / 2 < len2 <= len1.
+void BigInteger::multiplyToom3(const Limb* num1, size_t len1,
+                               const Limb* num2, size_t len2,
+                               Limb* result) {
+    size_t part_len = (len1 + 2) / 3;
+    auto part = [part_len](const Limb* num, size_t len, size_t index) {
+        size_t start = std::min(index * part_len, len);
+        size_t end = std::min(start + part_len, len);
+        return fromLimbs(num + start, end - start);
+    };
+
+    BigInteger first0 = part(num1, len1, 0);
+    BigInteger first1 = part(num1, len1, 1);
+    BigInteger first2 = part(num1, len1, 2);
+    BigInteger second0 = part(num2, len2, 0);
+    BigInteger second1 = part(num2, len2, 1);
+    BigInteger second2 = part(num2, len2, 2);
+
+    BigInteger first_sum = first0 + first2;
+    BigInteger first_at_minus_one = first_sum - first1;
+    BigInteger first_at_one = first_sum + first1;
+    BigInteger first_at_minus_two = first_at_minus_one + first2;
+    first_at_minus_two += first_at_minus_two;
+    first_at_minus_two -= first0;
+
+    BigInteger second_sum = second0 + second2;
+    BigInteger second_at_minus_one = second_sum - second1;
+    BigInteger second_at_one = second_sum + second1;
+    BigInteger second_at_minus_two = second_at_minus_one + second2;
+    second_at_minus_two += second_at_minus_two;
+    second_at_minus_two -= second0;
+
+    BigInteger coef0;
+    BigInteger coef4;
+    BigInteger at_one;
+    BigInteger at_minus_one;
+    BigInteger at_minus_two;
+    runTasks(
+        len2, [&] { coef0 = first0 * second0; },
+        [&] { coef4 = first2 * second2; },
+        [&] { at_one = first_at_one * second_at_one; },
+        [&] { at_minus_one = first_at_minus_one * second_at_minus_one; },
+        [&] { at_minus_two = first_at_minus_two * second_at_minus_two; });
+
+    BigInteger coef3 = at_minus_two - at_one;
+    coef3.divideBySmall(3);
+    BigInteger coef1 = at_one - at_minus_one;
+    coef1.divideBySmall(2);
+    BigInteger coef2 = at_minus_one - coef0;
+    coef3 = coef2 - coef3;
+    coef3.divideBySmall(2);
+    coef3 += coef4;
+    coef3 += coef4;
+    coef2 += coef1;
+    coef2 -= coef4;
+    coef1 -= coef3;
+
+    size_t result_len = len1 + len2;
+    const BigInteger* coefs[] = {&coef0, &coef1, &coef2, &coef3, &coef4};
+    for (size_t i = 0; i < 5; ++i) {
+        if (*coefs[i]) {
+            addLimbs(result + i * part_len, result_len - i * part_len,
+                     coefs[i]->digits_.data(), coefs[i]->len());
+        }
+    }
+}
@@ -0,0 +1,212 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "LimbArithmetic.h"
+
+namespace {
+  struct NTTPrime {
+      uint32_t mod;
+      uint32_t root;
+  };
+
+  constexpr NTTPrime kPrimes[] = {
+      {998'244'353, 3}, {167'772'161, 3}, {469'762'049, 3}};
+  const size_t kMaxTransformLen = size_t(1) << 23;
+
+#ifdef BIGINTEGER_BINARY_LIMBS
+  const size_t kPiecesPerLimb = 2;
+  const uint64_t kPieceBase = uint64_t(1) << 32;
+#else
+  const size_t kPiecesPerLimb = 1;
+  const uint64_t kPieceBase = 1'000'000'000;
+#endif
+
+  // Chunking keeps the shorter operand of every transform at or below
+  // kMaxTransformLen / 2 pieces, which bounds the convolution coefficients
+  // that CRT recombination has to reproduce exactly.
+  static_assert(static_cast<unsigned __int128>(kMaxTransformLen / 2) *
+                        (kPieceBase - 1) * (kPieceBase - 1) <
+                    static_cast<unsigned __int128>(kPrimes[0].mod) *
+                        kPrimes[1].mod * kPrimes[2].mod,
+                "NTT coefficients must stay below the product of the primes");
+
+  uint32_t powModPrime(uint64_t base, uint64_t exp, uint32_t mod) {
+      uint64_t result = 1;
+      base %= mod;
+      while (exp > 0) {
+          if (exp & 1) {
+              result = result * base % mod;
+          }
+          base = base * base % mod;
+          exp >>= 1;
+      }
+      return result;
+  }
+
+  void transform(std::vector<uint32_t>& values, const NTTPrime& prime,
+                 bool inverse) {
+      size_t size = values.size();
+      uint32_t mod = prime.mod;
+      for (size_t i = 1, j = 0; i < size; ++i) {
+          size_t bit = size >> 1;
+          for (; j & bit; bit >>= 1) {
+              j ^= bit;
+          }
+          j ^= bit;
+          if (i < j) {
+              std::swap(values[i], values[j]);
+          }
+      }
+      std::vector<uint32_t> roots(size / 2);
+      for (size_t len = 2; len <= size; len <<= 1) {
+          uint64_t step = powModPrime(prime.root, (mod - 1) / len, mod);
+          if (inverse) {
+              step = powModPrime(step, mod - 2, mod);
+          }
+          size_t half = len / 2;
+          roots[0] = 1;
+          for (size_t k = 1; k < half; ++k) {
+              roots[k] = roots[k - 1] * step % mod;
+          }
+          for (size_t start = 0; start < size; start += len) {
+              uint32_t* low = values.data() + start;
+              uint32_t* high = low + half;
+              for (size_t k = 0; k < half; ++k) {
+                  uint32_t odd = uint64_t(high[k]) * roots[k] % mod;
+                  uint32_t even = low[k];
+                  low[k] = even + odd >= mod ? even + odd - mod : even + odd;
+                  high[k] = even >= odd ? even - odd : even + mod - odd;
+              }
+          }
+      }
+      if (inverse) {
+          uint64_t size_inverse = powModPrime(size, mod - 2, mod);
+          for (uint32_t& value : values) {
+              value = value * size_inverse % mod;
+          }
+      }
+  }
+
+  std::vector<uint32_t> convolve(const std::vector<uint32_t>& pieces1,
+                                 const std::vector<uint32_t>& pieces2,
+                                 size_t size, const NTTPrime& prime) {
+      std::vector<uint32_t> first(size, 0);
+      std::vector<uint32_t> second(size, 0);
+      for (size_t i = 0; i < pieces1.size(); ++i) {
+          first[i] = pieces1[i] % prime.mod;
+      }
+      for (size_t i = 0; i < pieces2.size(); ++i) {
+          second[i] = pieces2[i] % prime.mod;
+      }
+      transform(first, prime, false);
+      transform(second, prime, false);
+      for (size_t i = 0; i < size; ++i) {
+          first[i] = uint64_t(first[i]) * second[i] % prime.mod;
+      }
+      transform(first, prime, true);
+      return first;
+  }
+}
+
+BigInteger BigInteger::multiplyNTT(const BigInteger& num1,
+                                   const BigInteger& num2) {
+    BigInteger result;
+    result.digits_.assign(num1.len() + num2.len(), 0);
+    multiplyLimbsNTT(num1.digits_.data(), num1.len(), num2.digits_.data(),
+                     num2.len(), result.digits_.data());
+    result.is_negative_ = num1.is_negative_ != num2.is_negative_;
+    result.normalizeNum();
+    return result;
+}
+
+// Limbs are split into pieces below 2^32. A coefficient of the piece
+// convolution is a sum of at most min(len1, len2) products of two pieces,
+// so it is at most min(len1, len2) * (kPieceBase - 1)^2 with the lengths
+// counted in pieces. Longer operands are cut into chunks whose shorter
+// side has at most kMaxTransformLen / 2 pieces, and the static_assert
+// above keeps that bound below the product of the three primes, so CRT
+// recombination is exact. The bound on the total transform length alone
+// would not be enough: 2^23 * 2^64 exceeds the prime product.
+void BigInteger::multiplyLimbsNTT(const Limb* num1, size_t len1,
+                                  const Limb* num2, size_t len2, Limb* result) {
+    if (len1 == 0 || len2 == 0) {
+        return;
+    }
+    if ((len1 + len2) * kPiecesPerLimb > kMaxTransformLen) {
+        size_t chunk_len = kMaxTransformLen / kPiecesPerLimb / 2;
+        std::vector<Limb> chunk_product;
+        for (size_t i = 0; i < len1; i += chunk_len) {
+            size_t chunk_len1 = std::min(chunk_len, len1 - i);
+            for (size_t j = 0; j < len2; j += chunk_len) {
+                size_t chunk_len2 = std::min(chunk_len, len2 - j);
+                chunk_product.assign(chunk_len1 + chunk_len2, 0);
+                multiplyLimbsNTT(num1 + i, chunk_len1, num2 + j, chunk_len2,
+                                 chunk_product.data());
+                addLimbs(result + i + j, len1 + len2 - i - j,
+                         chunk_product.data(), chunk_product.size());
+            }
+        }
+        return;
+    }
+
+    auto split = [](const Limb* num, size_t len) {
+        std::vector<uint32_t> pieces(len * kPiecesPerLimb);
+        for (size_t i = 0; i < len; ++i) {
+            Limb limb = num[i];
+            for (size_t j = 0; j < kPiecesPerLimb; ++j) {
+                pieces[i * kPiecesPerLimb + j] = limb % kPieceBase;
+                limb /= kPieceBase;
+            }
+        }
+        return pieces;
+    };
+    std::vector<uint32_t> pieces1 = split(num1, len1);
+    std::vector<uint32_t> pieces2 = split(num2, len2);
+    size_t pieces_len = pieces1.size() + pieces2.size();
+
+    size_t size = 1;
+    while (size < pieces_len - 1) {
+        size <<= 1;
+    }
+    std::vector<uint32_t> residues[3];
+    auto residue = [&](size_t i) {
+        return [&, i] {
+            residues[i] = convolve(pieces1, pieces2, size, kPrimes[i]);
+        };
+    };
+    runTasks(std::min(len1, len2), residue(0), residue(1), residue(2));
+
+    const uint64_t mod1 = kPrimes[0].mod;
+    const uint64_t mod2 = kPrimes[1].mod;
+    const uint64_t mod3 = kPrimes[2].mod;
+    const uint64_t mod1_inverse = powModPrime(mod1, mod2 - 2, mod2);
+    const uint64_t mod12_inverse =
+        powModPrime(mod1 * mod2 % mod3, mod3 - 2, mod3);
+
+    unsigned __int128 carry = 0;
+    for (size_t i = 0; i < len1 + len2; ++i) {
+        Limb limb = 0;
+        Limb piece_weight = 1;
+        for (size_t j = 0; j < kPiecesPerLimb; ++j) {
+            size_t index = i * kPiecesPerLimb + j;
+            unsigned __int128 coefficient = carry;
+            if (index + 1 < pieces_len) {
+                uint64_t residue1 = residues[0][index];
+                uint64_t residue2 = residues[1][index];
+                uint64_t residue3 = residues[2][index];
+                uint64_t part2 =
+                    (residue2 + mod2 - residue1 % mod2) * mod1_inverse % mod2;
+                uint64_t low = residue1 + mod1 * part2;
+                uint64_t part3 = (residue3 + mod3 - low % mod3) % mod3 *
+                                 mod12_inverse % mod3;
+                coefficient +=
+                    low + static_cast<unsigned __int128>(mod1 * mod2) * part3;
+            }
+            limb += static_cast<Limb>(coefficient % kPieceBase) * piece_weight;
+            carry = coefficient / kPieceBase;
+            piece_weight *= kPieceBase;
+        }
+        result[i] = limb;
+    }
+}
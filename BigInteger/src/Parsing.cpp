@@ -0,0 +1,222 @@
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <streambuf>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "LimbArithmetic.h"
+
+namespace {
+  bool isDigit(char symbol) { return symbol >= '0' && symbol <= '9'; }
+
+  // Decodes eight ASCII digits with three multiplications: neighbouring
+  // digits, then pairs, then quadruples are combined inside one word.
+  uint64_t parseEightDigits(const char* digits) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    uint64_t value;
+    std::memcpy(&value, digits, sizeof(value));
+    value -= 0x3030303030303030;
+    value = value * 10 + (value >> 8);
+    value = ((value & 0x000000FF000000FF) * (100 + (1000000ULL << 32)) +
+             ((value >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32))) >>
+            32;
+    return value;
+#else
+    uint64_t value = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        value = value * 10 + (digits[i] - '0');
+    }
+    return value;
+#endif
+  }
+
+  // Value of len <= 19 digits.
+  uint64_t parseChunk(const char* digits, size_t len) {
+    uint64_t value = 0;
+    size_t head = len % 8;
+    for (size_t i = 0; i < head; ++i) {
+        value = value * 10 + (digits[i] - '0');
+    }
+    for (size_t i = head; i < len; i += 8) {
+        value = value * 100'000'000 + parseEightDigits(digits + i);
+    }
+    return value;
+  }
+
+  // The get area of a stream buffer is only reachable from derived
+  // classes, but pointers to its protected members formed in one work on
+  // any buffer.
+  struct GetArea : std::streambuf {
+      static const char* begin(std::streambuf* buffer) {
+          return (buffer->*&GetArea::gptr)();
+      }
+      static const char* end(std::streambuf* buffer) {
+          return (buffer->*&GetArea::egptr)();
+      }
+      static void consume(std::streambuf* buffer, size_t count) {
+          (buffer->*&GetArea::gbump)(static_cast<int>(count));
+      }
+  };
+}
+
+BigInteger BigInteger::fromDigits(const char* digits, size_t len,
+                                  bool is_negative) {
+    LimbVector chunks;
+    chunks.reserve(len / kBIBaseSize_ + 1);
+    for (size_t end = len; end > 0;) {
+        size_t start = end - std::min(end, kBIBaseSize_);
+        chunks.push_back(
+            static_cast<Limb>(parseChunk(digits + start, end - start)));
+        end = start;
+    }
+    BigInteger num = fromDecimalChunks(chunks.data(), chunks.size());
+    num.is_negative_ = is_negative;
+    num.normalizeNum();
+    return num;
+}
+
+// Decodes the run of digits at the front of buffer into num and returns
+// its length; num is left alone when there are none. Runs of digits are
+// scanned in place in the get area and decoded kBIBaseSize_ at a time,
+// most significant chunk first, so the digits are never copied. Only a
+// chunk split by a refill, or a buffer without a get area, goes through
+// the small pending array. The chunks are aligned from the wrong end,
+// which one multiplication by a power of ten at the end fixes.
+size_t BigInteger::readDigits(std::streambuf* buffer, bool is_negative,
+                              BigInteger& num, bool& at_eof) {
+    using Traits = std::streambuf::traits_type;
+    LimbVector chunks;
+    char pending[kBIBaseSize_];
+    size_t pending_len = 0;
+    size_t count = 0;
+    auto append = [&](const char* digits, size_t len) {
+        count += len;
+        while (len > 0) {
+            if (pending_len == 0 && len >= kBIBaseSize_) {
+                chunks.push_back(
+                    static_cast<Limb>(parseChunk(digits, kBIBaseSize_)));
+                digits += kBIBaseSize_;
+                len -= kBIBaseSize_;
+                continue;
+            }
+            size_t take = std::min(kBIBaseSize_ - pending_len, len);
+            std::memcpy(pending + pending_len, digits, take);
+            pending_len += take;
+            digits += take;
+            len -= take;
+            if (pending_len == kBIBaseSize_) {
+                chunks.push_back(
+                    static_cast<Limb>(parseChunk(pending, kBIBaseSize_)));
+                pending_len = 0;
+            }
+        }
+    };
+
+    const size_t kMaxScan = std::numeric_limits<int>::max();
+    while (true) {
+        const char* begin = GetArea::begin(buffer);
+        const char* end = GetArea::end(buffer);
+        if (begin == end) {
+            Traits::int_type next = buffer->sgetc();
+            if (next == Traits::eof()) {
+                at_eof = true;
+                break;
+            }
+            if (GetArea::begin(buffer) != GetArea::end(buffer)) {
+                continue;
+            }
+            if (!isDigit(Traits::to_char_type(next))) {
+                break;
+            }
+            char digit = Traits::to_char_type(next);
+            append(&digit, 1);
+            buffer->sbumpc();
+            continue;
+        }
+        end = begin + std::min<size_t>(end - begin, kMaxScan);
+        const char* stop = begin;
+        while (stop < end && isDigit(*stop)) {
+            ++stop;
+        }
+        append(begin, stop - begin);
+        GetArea::consume(buffer, stop - begin);
+        if (stop < end) {
+            break;
+        }
+    }
+    if (count == 0) {
+        return 0;
+    }
+
+    std::reverse(chunks.begin(), chunks.end());
+    num = chunks.empty() ? BigInteger()
+                         : fromDecimalChunks(chunks.data(), chunks.size());
+    if (pending_len > 0) {
+        Limb scale = 1;
+        for (size_t i = 0; i < pending_len; ++i) {
+            scale *= 10;
+        }
+        num.multiplyBySmall(scale);
+        num.addSmall(static_cast<Limb>(parseChunk(pending, pending_len)),
+                     false);
+    }
+    num.is_negative_ = is_negative;
+    num.normalizeNum();
+    return count;
+}
+
+std::vector<BigInteger> BigInteger::parseAll(std::string_view text) {
+    std::vector<BigInteger> numbers;
+    const char* data = text.data();
+    size_t size = text.size();
+    for (size_t i = 0; i < size;) {
+        if (!isDigit(data[i])) {
+            ++i;
+            continue;
+        }
+        size_t start = i;
+        while (i < size && isDigit(data[i])) {
+            ++i;
+        }
+        bool is_negative = start > 0 && data[start - 1] == '-';
+        numbers.push_back(fromDigits(data + start, i - start, is_negative));
+    }
+    return numbers;
+}
+
+std::vector<BigInteger> BigInteger::parseFile(const std::string& path) {
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    struct stat info;
+    if (fstat(file, &info) != 0) {
+        close(file);
+        throw std::runtime_error("Cannot read " + path);
+    }
+    size_t size = info.st_size;
+    if (size == 0) {
+        close(file);
+        return {};
+    }
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("Cannot map " + path);
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+    std::vector<BigInteger> numbers;
+    try {
+        numbers = parseAll({static_cast<const char*>(data), size});
+    } catch (...) {
+        munmap(data, size);
+        throw;
+    }
+    munmap(data, size);
+    return numbers;
+}
@@ -0,0 +1,121 @@
+#include <deque>
+#include <mutex>
+
+#include "LimbArithmetic.h"
+
+namespace {
+  std::mutex radix_powers_mutex;
+}
+
+struct BigInteger::RadixPower {
+    BigInteger power;
+    BigInteger reciprocal;
+};
+
+// Returns kDecimalBase_^(2^level). The table is shared by all conversions
+// and only grows, so returned references stay valid.
+const BigInteger::RadixPower& BigInteger::radixPower(size_t level,
+                                                     bool with_reciprocal) {
+    static std::deque<RadixPower> powers;
+    std::lock_guard<std::mutex> lock(radix_powers_mutex);
+    if (powers.empty()) {
+        Limb chunks[] = {0, 1};
+        powers.push_back({fromDecimalChunks(chunks, 2), 0});
+    }
+    while (powers.size() <= level) {
+        const BigInteger& previous = powers.back().power;
+        powers.push_back({previous * previous, 0});
+    }
+    RadixPower& entry = powers[level];
+    if (with_reciprocal && !entry.reciprocal) {
+        entry.reciprocal = reciprocal(entry.power);
+    }
+    return entry;
+}
+
+BigInteger::LimbVector BigInteger::toDecimalChunks() const {
+    if (kBIBase_ == kDecimalBase_) {
+        return digits_;
+    }
+    BigInteger magnitude = *this;
+    magnitude.is_negative_ = false;
+    LimbVector chunks;
+    if (len() <= kRadixThreshold_) {
+        peelDecimalChunks(magnitude, chunks);
+        return chunks;
+    }
+    size_t level = 0;
+    while (radixPower(level, false).power.len() <= len()) {
+        ++level;
+    }
+    chunks.reserve(size_t(1) << level);
+    appendDecimalChunks(magnitude, level, chunks);
+    while (chunks.size() > 1 && chunks.back() == 0) {
+        chunks.pop_back();
+    }
+    return chunks;
+}
+
+// Appends exactly 2^level chunks of a nonnegative num below
+// kDecimalBase_^(2^level), splitting by cached powers of kDecimalBase_.
+void BigInteger::appendDecimalChunks(const BigInteger& num, size_t level,
+                                     LimbVector& chunks) {
+    if (num.len() <= kRadixThreshold_) {
+        size_t chunks_end = chunks.size() + (size_t(1) << level);
+        peelDecimalChunks(num, chunks);
+        chunks.resize(chunks_end, 0);
+        return;
+    }
+    const RadixPower& split = radixPower(level - 1, true);
+    BigInteger high = num * split.reciprocal;
+    high.shiftLimbsRight(2 * split.power.len());
+    BigInteger low = num - high * split.power;
+    while (low >= split.power) {
+        ++high;
+        low -= split.power;
+    }
+    appendDecimalChunks(low, level - 1, chunks);
+    appendDecimalChunks(high, level - 1, chunks);
+}
+
+void BigInteger::peelDecimalChunks(BigInteger num, LimbVector& chunks) {
+    do {
+        DoubleLimb remainder = 0;
+        for (size_t i = num.len(); i > 0; --i) {
+            DoubleLimb cur_digit = remainder * kBIBase_ + num.digits_[i - 1];
+            num.digits_[i - 1] = static_cast<Limb>(cur_digit / kDecimalBase_);
+            remainder = cur_digit % kDecimalBase_;
+        }
+        num.normalizeNum();
+        chunks.push_back(static_cast<Limb>(remainder));
+    } while (!num.isZero());
+}
+
+BigInteger BigInteger::fromDecimalChunks(const Limb* chunks, size_t count) {
+    BigInteger num;
+    if (kBIBase_ == kDecimalBase_) {
+        num.digits_.assign(chunks, chunks + count);
+    } else if (count <= kRadixThreshold_) {
+        num.digits_.clear();
+        for (size_t i = count; i > 0; --i) {
+            Limb carry = chunks[i - 1];
+            for (Limb& digit : num.digits_) {
+                digit = multiplyAdd(digit, kDecimalBase_, 0, carry);
+            }
+            if (carry != 0) {
+                num.digits_.push_back(carry);
+            }
+        }
+    } else {
+        size_t level = 0;
+        while ((size_t(2) << level) < count) {
+            ++level;
+        }
+        size_t low_count = size_t(1) << level;
+        num = fromDecimalChunks(chunks + low_count, count - low_count);
+        num *= radixPower(level, false).power;
+        num += fromDecimalChunks(chunks, low_count);
+    }
+    num.normalizeNum();
+    return num;
+}
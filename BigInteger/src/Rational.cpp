@@ -1,17 +1,76 @@
 #include "Rational.h"
 
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+#include "BigIntegerModular.h"
+
+namespace {
+  // num2 is positive, so the result fits even for num1 = INT64_MIN.
+  int64_t smallGcd(int64_t num1, int64_t num2) {
+    uint64_t magnitude = num1 < 0 ? 0 - static_cast<uint64_t>(num1)
+                                  : static_cast<uint64_t>(num1);
+    return static_cast<int64_t>(
+        std::gcd(magnitude, static_cast<uint64_t>(num2)));
+  }
+}
+
 Rational::Rational() : numerator_(0), denominator_(1) {};
-Rational::Rational(int num) : numerator_(num), denominator_(1) {};
-Rational::Rational(const BigInteger& num) : numerator_(num), denominator_(1) {};
+Rational::Rational(const BigInteger& num)
+    : numerator_(num), denominator_(1), is_small_(false) {
+    demote();
+};
 Rational::Rational(const BigInteger& numerator, const BigInteger& denominator) {
     numerator_ = numerator;
     denominator_ = denominator;
+    is_small_ = false;
     setSign(numerator_, (numerator_ < 0) == (denominator_ < 0));
     setSign(denominator_, true);
     toCoPrime();
 }
 
+Rational::Rational(double num) {
+    if (!std::isfinite(num)) {
+        throw std::invalid_argument("Rational needs a finite double");
+    }
+    int exponent = 0;
+    double fraction = std::frexp(num, &exponent);
+    int64_t mantissa = static_cast<int64_t>(std::ldexp(fraction, 53));
+    exponent -= 53;
+    while (mantissa != 0 && mantissa % 2 == 0 && exponent < 0) {
+        mantissa /= 2;
+        ++exponent;
+    }
+    if (mantissa == 0) {
+        return;
+    }
+    numerator_ = mantissa;
+    denominator_ = 1;
+    is_small_ = false;
+    if (exponent > 0) {
+        numerator_ *= BigInteger::powerOfTwo(exponent);
+    } else {
+        denominator_ = BigInteger::powerOfTwo(-exponent);
+    }
+    demote();
+}
+
 std::string Rational::toString() const {
+    if (is_small_) {
+        std::string str_num = std::to_string(small_numerator_);
+        if (small_denominator_ != 1) {
+            str_num += '/';
+            str_num += std::to_string(small_denominator_);
+        }
+        return str_num;
+    }
+    if (!is_reduced_) {
+        Rational reduced = *this;
+        reduced.toCoPrime();
+        return reduced.toString();
+    }
     std::string str_num;
     str_num += numerator_.toString();
     if (denominator_ != 1) {
@@ -21,60 +80,239 @@ std::string Rational::toString() const {
     return str_num;
 }
 
+// Truncates |num| * 10^precision / den with a single division.
 std::string Rational::asDecimal(size_t precision) const {
+    if (is_small_) {
+        Rational big = *this;
+        big.promote();
+        return big.asDecimal(precision);
+    }
+    BigInteger scaled = numerator_;
+    setSign(scaled, true);
+    scaled *= BigInteger::powerOfTen(precision);
+    std::string digits = (scaled / denominator_).toString();
+    if (digits.size() <= precision) {
+        digits.insert(0, precision + 1 - digits.size(), '0');
+    }
+    size_t integer_len = digits.size() - precision;
     std::string decimal;
+    decimal.reserve(digits.size() + 2);
     if (numerator_ < 0) {
-        decimal += "-";
+        decimal += '-';
     }
-    decimal += (numerator_ / denominator_).toString();
+    decimal.append(digits, 0, integer_len);
     if (precision > 0) {
-        BigInteger numerator_copy(numerator_ % denominator_);
-        setSign(numerator_copy, true);
-        decimal += ".";
-        for (size_t i = 0; i < precision; ++i) {
-            numerator_copy *= 10;
-            decimal += (numerator_copy / denominator_).toString();
-            numerator_copy %= denominator_;
-        }
+        decimal += '.';
+        decimal.append(digits, integer_len, precision);
     }
     return decimal;
 }
 
-Rational::operator double() const { return std::stod(asDecimal(15)); }
+// Each chunk scales the running remainder by a power of ten at least as
+// long as the denominator, so the chunk divisions stay balanced.
+void Rational::writeDecimal(std::ostream& out, size_t precision) const {
+    if (is_small_) {
+        Rational big = *this;
+        big.promote();
+        big.writeDecimal(out, precision);
+        return;
+    }
+    BigInteger::Divisor denominator(denominator_);
+    auto [integer_part, remainder] = denominator.divmod(numerator_);
+    setSign(integer_part, true);
+    setSign(remainder, true);
+    if (numerator_ < 0) {
+        out << '-';
+    }
+    out << integer_part;
+    if (precision == 0) {
+        return;
+    }
+    out << '.';
+    size_t chunk_len = std::max(kDecimalChunkDigits_,
+                                denominator_.bitLength() * 3 / 10 + 1);
+    BigInteger chunk_power = BigInteger::powerOfTen(chunk_len);
+    for (size_t written = 0; written < precision; written += chunk_len) {
+        size_t len = std::min(chunk_len, precision - written);
+        if (len == chunk_len) {
+            remainder *= chunk_power;
+        } else {
+            remainder *= BigInteger::powerOfTen(len);
+        }
+        auto [digits, rest] = denominator.divmod(remainder);
+        std::string text = digits.toString();
+        out << std::string(len - text.size(), '0') << text;
+        remainder = std::move(rest);
+    }
+}
+
+// Scales the magnitude so that the quotient has 55 or 56 bits, rounds it
+// to the precision of the result (fewer bits for subnormals) with the
+// remainder as a sticky bit, and applies the exponent with ldexp, which
+// is exact at that point.
+Rational::operator double() const {
+    if (is_small_) {
+        // Both terms are exact doubles, so one division rounds correctly.
+        const int64_t kExact = int64_t(1) << 53;
+        if (-kExact <= small_numerator_ && small_numerator_ <= kExact &&
+            small_denominator_ <= kExact) {
+            return double(small_numerator_) / double(small_denominator_);
+        }
+        Rational big = *this;
+        big.promote();
+        return static_cast<double>(big);
+    }
+    if (numerator_ == 0) {
+        return 0.0;
+    }
+    BigInteger numerator = numerator_;
+    setSign(numerator, true);
+    BigInteger denominator = denominator_;
+    int64_t shift = 55 + int64_t(denominator.bitLength()) -
+                    int64_t(numerator.bitLength());
+    if (shift > 0) {
+        numerator *= BigInteger::powerOfTwo(shift);
+    } else if (shift < 0) {
+        denominator *= BigInteger::powerOfTwo(-shift);
+    }
+    auto [quotient, remainder] = divmod(numerator, denominator);
+    uint64_t bits = static_cast<uint64_t>(quotient.toInt64());
+    bool sticky = static_cast<bool>(remainder);
+
+    int64_t bit_count = 64 - __builtin_clzll(bits);
+    int64_t exponent = bit_count - 1 - shift;
+    int64_t precision = 53;
+    if (exponent < -1022) {
+        precision -= -1022 - exponent;
+    }
+    double result = 0.0;
+    if (precision >= 0) {
+        int64_t dropped = bit_count - precision;
+        uint64_t kept = bits >> dropped;
+        uint64_t rest = bits - (kept << dropped);
+        uint64_t half = uint64_t(1) << (dropped - 1);
+        if (rest > half || (rest == half && (sticky || kept % 2 != 0))) {
+            ++kept;
+        }
+        int64_t scale = std::clamp<int64_t>(dropped - shift, -2000, 2000);
+        result = std::ldexp(double(kept), int(scale));
+    }
+    return numerator_ < 0 ? -result : result;
+}
+
+void Rational::serialize(std::ostream& out) const {
+    if (is_small_) {
+        BigInteger(small_numerator_).serialize(out);
+        BigInteger(small_denominator_).serialize(out);
+        return;
+    }
+    numerator_.serialize(out);
+    denominator_.serialize(out);
+}
+
+Rational Rational::deserialize(std::istream& in) {
+    BigInteger numerator = BigInteger::deserialize(in);
+    BigInteger denominator = BigInteger::deserialize(in);
+    if (!denominator) {
+        throw std::invalid_argument("Rational denominator must be nonzero");
+    }
+    return Rational(numerator, denominator);
+}
 
 Rational Rational::operator-() const {
     Rational num = *this;
+    if (num.is_small_ &&
+        num.small_numerator_ != std::numeric_limits<int64_t>::min()) {
+        num.small_numerator_ = -num.small_numerator_;
+        return num;
+    }
+    num.promote();
     num.numerator_ = -num.numerator_;
     return num;
 }
 
 Rational& Rational::operator+=(const Rational& num) {
+    if (is_small_ && num.is_small_ &&
+        addSmall(num.small_numerator_, num.small_denominator_)) {
+        return *this;
+    }
+    if (num.is_small_) {
+        Rational other = num;
+        other.promote();
+        return *this += other;
+    }
+    promote();
     numerator_ = numerator_ * num.denominator_ + num.numerator_ * denominator_;
     denominator_ *= num.denominator_;
-    toCoPrime();
+    reduceIfNeeded();
     return *this;
 }
 
 Rational& Rational::operator-=(const Rational& num) { return *this += -num; }
 
 Rational& Rational::operator*=(const Rational& num) {
+    if (is_small_ && num.is_small_ &&
+        multiplySmall(num.small_numerator_, num.small_denominator_)) {
+        return *this;
+    }
+    if (num.is_small_) {
+        Rational other = num;
+        other.promote();
+        return *this *= other;
+    }
+    promote();
     numerator_ *= num.numerator_;
     denominator_ *= num.denominator_;
-    toCoPrime();
+    reduceIfNeeded();
     return *this;
 }
 
 Rational& Rational::operator/=(const Rational& num) {
+    if (is_small_ && num.is_small_ && num.small_numerator_ != 0) {
+        // The inverse of a reduced fraction is reduced as well.
+        int64_t numerator = num.small_denominator_;
+        int64_t denominator = num.small_numerator_;
+        if (denominator != std::numeric_limits<int64_t>::min()) {
+            if (denominator < 0) {
+                numerator = -numerator;
+                denominator = -denominator;
+            }
+            if (multiplySmall(numerator, denominator)) {
+                return *this;
+            }
+        }
+    }
+    if (num.is_small_) {
+        Rational other = num;
+        other.promote();
+        return *this /= other;
+    }
+    promote();
     numerator_ *= num.denominator_;
     denominator_ *= num.numerator_;
     if (num.numerator_ < 0) {
         denominator_ *= -1;
         numerator_ *= -1;
     }
-    toCoPrime();
+    reduceIfNeeded();
     return *this;
 }
 
+void Rational::setLazy(bool is_lazy) {
+    is_lazy_ = is_lazy;
+    if (!is_lazy_ && !is_reduced_) {
+        toCoPrime();
+    }
+}
+
+bool Rational::isLazy() const { return is_lazy_; }
+
+void Rational::normalize() {
+    if (!is_reduced_) {
+        toCoPrime();
+    }
+}
+
 Rational operator+(Rational num1, const Rational& num2) { return num1 += num2; }
 
 Rational operator-(Rational num1, const Rational& num2) { return num1 -= num2; }
@@ -84,6 +322,12 @@ Rational operator*(Rational num1, const Rational& num2) { return num1 *= num2; }
 Rational operator/(Rational num1, const Rational& num2) { return num1 /= num2; }
 
 bool operator<(Rational num1, Rational num2) {
+    if (num1.is_small_ && num2.is_small_) {
+        return __int128(num1.small_numerator_) * num2.small_denominator_ <
+               __int128(num2.small_numerator_) * num1.small_denominator_;
+    }
+    num1.promote();
+    num2.promote();
     BigInteger lms = Rational::lms(num1.denominator_, num2.denominator_);
     num1.numerator_ *= lms / num1.denominator_;
     num2.numerator_ *= lms / num2.denominator_;
@@ -110,24 +354,100 @@ bool operator>=(const Rational& num1, const Rational& num2) {
     return !(num1 < num2);
 }
 
-BigInteger Rational::gcd(BigInteger num1, BigInteger num2) {
+BigInteger Rational::lms(BigInteger num1, BigInteger num2) {
     setSign(num1, true);
     setSign(num2, true);
-    while (num2 != 0) {
-        num1 %= num2;
-        std::swap(num1, num2);
+    return num1 * num2 / gcd(num1, num2);
+}
+
+void Rational::toCoPrime() {
+    BigInteger common = gcd(numerator_, denominator_);
+    if (common != 1) {
+        BigInteger::Divisor divisor(common);
+        numerator_ = divisor.divmod(numerator_).first;
+        denominator_ = divisor.divmod(denominator_).first;
     }
-    return num1;
+    is_reduced_ = true;
+    reduce_at_ = std::max(kLazyMinLimbs_, 2 * (numerator_.limbCount() +
+                                               denominator_.limbCount()));
+    demote();
 }
 
-BigInteger Rational::lms(BigInteger num1, BigInteger num2) {
-    setSign(num1, true);
-    setSign(num2, true);
-    return num1 * num2 / Rational::gcd(num1, num2);
+void Rational::reduceIfNeeded() {
+    if (!is_lazy_ ||
+        numerator_.limbCount() + denominator_.limbCount() >= reduce_at_) {
+        toCoPrime();
+    } else {
+        is_reduced_ = false;
+    }
+}
+void Rational::promote() {
+    if (is_small_) {
+        numerator_ = small_numerator_;
+        denominator_ = small_denominator_;
+        is_small_ = false;
+        is_reduced_ = true;
+    }
 }
 
-void Rational::toCoPrime() {
-    BigInteger gcd = Rational::gcd(numerator_, denominator_);
-    numerator_ /= gcd;
-    denominator_ /= gcd;
-}
\ No newline at end of file
+// Only called on reduced values.
+void Rational::demote() {
+    if (numerator_.bitLength() < 64 && denominator_.bitLength() < 64) {
+        small_numerator_ = numerator_.toInt64();
+        small_denominator_ = denominator_.toInt64();
+        is_small_ = true;
+    }
+}
+
+// a/b + c/d = (a * (d/g) + c * (b/g)) / (b * (d/g)) / h for g = gcd(b, d),
+// where only h = gcd(sum, g) can remain in common. Returns false and
+// leaves the value untouched on overflow.
+bool Rational::addSmall(int64_t numerator, int64_t denominator) {
+    int64_t common = smallGcd(small_denominator_, denominator);
+    int64_t first_part = small_denominator_ / common;
+    int64_t second_part = denominator / common;
+    int64_t first = 0;
+    int64_t second = 0;
+    int64_t sum = 0;
+    int64_t product = 0;
+    if (__builtin_mul_overflow(small_numerator_, second_part, &first) ||
+        __builtin_mul_overflow(numerator, first_part, &second) ||
+        __builtin_add_overflow(first, second, &sum) ||
+        __builtin_mul_overflow(small_denominator_, second_part, &product)) {
+        return false;
+    }
+    if (sum == 0) {
+        small_numerator_ = 0;
+        small_denominator_ = 1;
+        return true;
+    }
+    int64_t rest = smallGcd(sum, common);
+    small_numerator_ = sum / rest;
+    small_denominator_ = product / rest;
+    return true;
+}
+
+// Cross-cancels a/b * c/d by gcd(a, d) and gcd(c, b) first, which leaves
+// the product reduced.
+bool Rational::multiplySmall(int64_t numerator, int64_t denominator) {
+    if (small_numerator_ == 0 || numerator == 0) {
+        small_numerator_ = 0;
+        small_denominator_ = 1;
+        return true;
+    }
+    int64_t first_common = smallGcd(small_numerator_, denominator);
+    int64_t second_common = smallGcd(numerator, small_denominator_);
+    int64_t result_numerator = 0;
+    int64_t result_denominator = 0;
+    if (__builtin_mul_overflow(small_numerator_ / first_common,
+                               numerator / second_common,
+                               &result_numerator) ||
+        __builtin_mul_overflow(small_denominator_ / second_common,
+                               denominator / first_common,
+                               &result_denominator)) {
+        return false;
+    }
+    small_numerator_ = result_numerator;
+    small_denominator_ = result_denominator;
+    return true;
+}
@@ -0,0 +1,217 @@
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+#include "LimbArithmetic.h"
+
+namespace {
+  // A Mersenne prime for the cheap test that rules out most candidate
+  // roots in isPerfectPower before their power is computed.
+  const uint64_t kCheckModulus = (uint64_t(1) << 61) - 1;
+
+  BigInteger raise(BigInteger base, size_t exponent) {
+    BigInteger power = 1;
+    for (; exponent > 0; exponent >>= 1) {
+        if (exponent & 1) {
+            power *= base;
+        }
+        if (exponent > 1) {
+            base *= base;
+        }
+    }
+    return power;
+  }
+
+  uint64_t raiseModulo(uint64_t base, size_t exponent, uint64_t mod) {
+    uint64_t power = 1;
+    for (; exponent > 0; exponent >>= 1) {
+        if (exponent & 1) {
+            power = static_cast<uint64_t>((unsigned __int128)power * base %
+                                          mod);
+        }
+        base = static_cast<uint64_t>((unsigned __int128)base * base % mod);
+    }
+    return power;
+  }
+
+  bool isSmallPrime(size_t num) {
+    for (size_t divisor = 2; divisor * divisor <= num; ++divisor) {
+        if (num % divisor == 0) {
+            return false;
+        }
+    }
+    return num >= 2;
+  }
+}
+
+BigInteger isqrt(const BigInteger& num) {
+    if (num < 0) {
+        throw std::invalid_argument("isqrt of a negative number");
+    }
+    return iroot(num, 2);
+}
+
+BigInteger iroot(const BigInteger& num, size_t degree) {
+    if (degree == 0) {
+        throw std::invalid_argument("iroot needs a positive degree");
+    }
+    if (num.is_negative_) {
+        if (degree % 2 == 0) {
+            throw std::invalid_argument("Even root of a negative number");
+        }
+        return -BigInteger::rootFloor(-num, degree);
+    }
+    if (num.isZero() || degree == 1) {
+        return num;
+    }
+    return BigInteger::rootFloor(num, degree);
+}
+
+// Only prime exponents need to be tried, since a^(pq) = (a^q)^p. For each
+// one a root estimate from the top limbs picks the few candidates for a,
+// and only a candidate that passes the residue test is raised to the full
+// power.
+bool isPerfectPower(const BigInteger& num) {
+    BigInteger magnitude = num < 0 ? -num : num;
+    if (magnitude <= 1) {
+        return true;
+    }
+    const int64_t kModulus = static_cast<int64_t>(kCheckModulus);
+    uint64_t residue = divmod(magnitude, kModulus).second;
+    size_t bits = magnitude.bitLength();
+    for (size_t degree = num < 0 ? 3 : 2; degree <= bits; ++degree) {
+        if (!isSmallPrime(degree)) {
+            continue;
+        }
+        BigInteger estimate = BigInteger::rootEstimate(magnitude, degree);
+        uint64_t estimate_residue = divmod(estimate, kModulus).second;
+        for (int64_t offset = -2; offset <= 2; ++offset) {
+            uint64_t root_residue =
+                (estimate_residue + kCheckModulus + offset) % kCheckModulus;
+            if (raiseModulo(root_residue, degree, kCheckModulus) == residue &&
+                raise(estimate + offset, degree) == magnitude) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Newton's iteration x -> ((k - 1) x + n / x^(k - 1)) / k with floor
+// divisions never drops below floor(n^(1/k)) and strictly decreases above
+// it, so started above the root it reaches exactly the root. The start
+// comes from the root of n with its low k * t limbs dropped, which gives
+// the top half of the root's limbs; the last few steps then double the
+// precision at full size, and the recursion makes the total a constant
+// number of full-size multiplications and divisions. Roots of under two
+// limbs start from a floating point bound instead.
+BigInteger BigInteger::rootFloor(const BigInteger& num, size_t degree) {
+    size_t dropped = num.len() / degree / 2;
+    BigInteger root;
+    if (dropped > 0) {
+        BigInteger top = num;
+        top.shiftLimbsRight(degree * dropped);
+        root = rootFloor(top, degree) + 1;
+        root.shiftLimbsLeft(dropped);
+    } else {
+        root = rootUpperBound(num, degree);
+    }
+
+    // Every step lands on or above the root, so x^k <= n proves that x is
+    // the root; the power is much cheaper than the division of the step
+    // that would otherwise only confirm it.
+    const int64_t kDegree = static_cast<int64_t>(degree);
+    while (true) {
+        BigInteger next = root * (kDegree - 1);
+        next += num / raise(root, degree - 1);
+        next /= kDegree;
+        if (!(next < root) || !(num < raise(next, degree))) {
+            return next < root ? next : root;
+        }
+        root = std::move(next);
+    }
+}
+
+// The same iteration from a start built as in rootFloor, but with x^(k - 1)
+// kept to its top len / k + 4 limbs and n cut to match, so a step costs a
+// few products of that size rather than a full-size power and division.
+// The truncation errors stay far below one unit of the quotient, so every
+// step is within one of the exact step, and the iteration stops between
+// the root minus one and plus two.
+BigInteger BigInteger::rootEstimate(const BigInteger& num, size_t degree) {
+    const size_t kept = num.len() / degree + 4;
+    auto truncate = [kept](BigInteger& value, size_t& shift) {
+        if (value.len() > kept) {
+            shift += value.len() - kept;
+            value.shiftLimbsRight(value.len() - kept);
+        }
+    };
+
+    size_t dropped = num.len() / degree / 2;
+    BigInteger root;
+    if (dropped > 0) {
+        root = rootEstimate(fromLimbs(num.digits_.data() + degree * dropped,
+                                      num.len() - degree * dropped),
+                            degree) +
+               2;
+        root.shiftLimbsLeft(dropped);
+    } else {
+        root = rootUpperBound(num, degree);
+    }
+
+    const int64_t kDegree = static_cast<int64_t>(degree);
+    while (true) {
+        // power * kBIBase_^shift is root^(k - 1) rounded down.
+        BigInteger power = 1;
+        BigInteger base = root;
+        size_t shift = 0;
+        size_t base_shift = 0;
+        for (size_t exponent = degree - 1; exponent > 0; exponent >>= 1) {
+            if (exponent & 1) {
+                power *= base;
+                shift += base_shift;
+                truncate(power, shift);
+            }
+            if (exponent > 1) {
+                base *= base;
+                base_shift *= 2;
+                truncate(base, base_shift);
+            }
+        }
+        BigInteger next = root * (kDegree - 1);
+        if (shift < num.len()) {
+            next += fromLimbs(num.digits_.data() + shift,
+                              num.len() - shift) /
+                    power;
+        }
+        next /= kDegree;
+        if (!(next < root)) {
+            return root;
+        }
+        root = std::move(next);
+    }
+}
+
+// A floating point bound on the root from the top two limbs. They are
+// rounded up, and the margin on the logarithm is far above its rounding
+// error, so the bound stays above the root.
+BigInteger BigInteger::rootUpperBound(const BigInteger& num, size_t degree) {
+    double leading = double(num.digits_.back()) + 1;
+    size_t rest_len = num.len() - 1;
+    if (num.len() > 1) {
+        leading = double(num.digits_.back()) * kBIBase_ +
+                  num.digits_[num.len() - 2] + 1;
+        rest_len = num.len() - 2;
+    }
+    double log_root = (std::log2(leading) +
+                       rest_len * std::log2(double(kBIBase_))) /
+                          degree +
+                      1e-9;
+    if (log_root < 60) {
+        return uint64_t(std::exp2(log_root)) + 1;
+    }
+    size_t exponent = size_t(log_root) - 52;
+    BigInteger bound = uint64_t(std::exp2(log_root - exponent)) + 1;
+    bound *= powerOfTwo(exponent);
+    return bound;
+}
@@ -0,0 +1,169 @@
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+
+#include "BigIntegerView.h"
+#include "LimbArithmetic.h"
+
+namespace {
+  const char kMagic[2] = {'B', 'I'};
+  const uint8_t kVersion = 1;
+  // Limb formats: base 10^9 in four bytes and base 2^64 in eight.
+  const uint8_t kDecimalLimbs = 0;
+  const uint8_t kBinaryLimbs = 1;
+  const size_t kHeaderSize = 16;
+  const size_t kBlockLimbs = 4096;
+
+  size_t limbSize(uint8_t format) {
+    return format == kDecimalLimbs ? 4 : 8;
+  }
+
+  void storeLittleEndian(uint64_t value, size_t size, char* out) {
+    for (size_t i = 0; i < size; ++i) {
+        out[i] = static_cast<char>(value >> (8 * i));
+    }
+  }
+
+  uint64_t loadLittleEndian(const char* data, size_t size) {
+    uint64_t value = 0;
+    for (size_t i = size; i > 0; --i) {
+        value = (value << 8) | static_cast<unsigned char>(data[i - 1]);
+    }
+    return value;
+  }
+
+  [[noreturn]] void malformed() {
+    throw std::invalid_argument("Malformed BigInteger encoding");
+  }
+
+  // Parses a header and returns the limb count.
+  size_t readHeader(const char* header, uint8_t& format, bool& is_negative) {
+    if (header[0] != kMagic[0] || header[1] != kMagic[1] ||
+        static_cast<uint8_t>(header[2]) != kVersion) {
+        malformed();
+    }
+    format = static_cast<uint8_t>(header[3]);
+    if ((format != kDecimalLimbs && format != kBinaryLimbs) ||
+        static_cast<uint8_t>(header[4]) > 1) {
+        malformed();
+    }
+    is_negative = header[4] != 0;
+    return loadLittleEndian(header + 8, 8);
+  }
+
+  // Value of count limbs written by a build with the other base, split
+  // in halves so that the work is a few balanced multiplications.
+  BigInteger foreignLimbsValue(const char* data, size_t count,
+                               uint8_t format) {
+    size_t limb_size = limbSize(format);
+    if (count == 1) {
+        return BigInteger(loadLittleEndian(data, limb_size));
+    }
+    size_t half = count / 2;
+    BigInteger high =
+        foreignLimbsValue(data + limb_size * half, count - half, format);
+    high *= format == kDecimalLimbs ? BigInteger::powerOfTen(9 * half)
+                                    : BigInteger::powerOfTwo(64 * half);
+    high += foreignLimbsValue(data, half, format);
+    return high;
+  }
+}
+
+void BigInteger::serialize(std::ostream& out) const {
+    uint8_t format = kBIBase_ == kDecimalBase_ ? kDecimalLimbs : kBinaryLimbs;
+    size_t limb_size = limbSize(format);
+    char header[kHeaderSize] = {kMagic[0], kMagic[1]};
+    header[2] = static_cast<char>(kVersion);
+    header[3] = static_cast<char>(format);
+    header[4] = is_negative_ ? 1 : 0;
+    storeLittleEndian(len(), 8, header + 8);
+    out.write(header, kHeaderSize);
+
+    std::vector<char> block(std::min(len(), kBlockLimbs) * limb_size);
+    for (size_t start = 0; start < len(); start += kBlockLimbs) {
+        size_t count = std::min(kBlockLimbs, len() - start);
+        for (size_t i = 0; i < count; ++i) {
+            storeLittleEndian(digits_[start + i], limb_size,
+                              block.data() + i * limb_size);
+        }
+        out.write(block.data(), count * limb_size);
+    }
+}
+
+BigInteger BigInteger::deserialize(std::istream& in) {
+    char header[kHeaderSize];
+    if (!in.read(header, kHeaderSize)) {
+        malformed();
+    }
+    uint8_t format = 0;
+    bool is_negative = false;
+    size_t count = readHeader(header, format, is_negative);
+    size_t limb_size = limbSize(format);
+    // Read in blocks so that a corrupt count fails before allocating.
+    std::vector<char> limbs;
+    for (size_t read = 0; read < count; read += kBlockLimbs) {
+        size_t block = std::min(kBlockLimbs, count - read) * limb_size;
+        size_t offset = limbs.size();
+        limbs.resize(offset + block);
+        if (!in.read(limbs.data() + offset, block)) {
+            malformed();
+        }
+    }
+    return fromEncodedLimbs(limbs.data(), count, format, is_negative);
+}
+
+BigInteger BigInteger::fromEncodedLimbs(const char* data, size_t count,
+                                        uint8_t format, bool is_negative) {
+    if (count == 0) {
+        malformed();
+    }
+    size_t limb_size = limbSize(format);
+    if (format == kDecimalLimbs) {
+        for (size_t i = 0; i < count; ++i) {
+            if (loadLittleEndian(data + i * limb_size, limb_size) >=
+                kDecimalBase_) {
+                malformed();
+            }
+        }
+    }
+    BigInteger num;
+    bool is_native = (format == kDecimalLimbs) == (kBIBase_ == kDecimalBase_);
+    if (is_native) {
+        num.digits_.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            num.digits_[i] = static_cast<Limb>(
+                loadLittleEndian(data + i * limb_size, limb_size));
+        }
+    } else {
+        num = foreignLimbsValue(data, count, format);
+    }
+    num.is_negative_ = is_negative;
+    num.normalizeNum();
+    return num;
+}
+
+BigInteger::View::View(const char* data, size_t size) {
+    if (size < kHeaderSize) {
+        malformed();
+    }
+    limb_count_ = readHeader(data, format_, is_negative_);
+    if (limb_count_ == 0 ||
+        limb_count_ > (size - kHeaderSize) / limbSize(format_)) {
+        malformed();
+    }
+    limbs_ = data + kHeaderSize;
+}
+
+bool BigInteger::View::isNegative() const { return is_negative_; }
+
+size_t BigInteger::View::limbCount() const { return limb_count_; }
+
+size_t BigInteger::View::encodedSize() const {
+    return kHeaderSize + limb_count_ * limbSize(format_);
+}
+
+BigInteger BigInteger::View::value() const {
+    return fromEncodedLimbs(limbs_, limb_count_, format_, is_negative_);
+}
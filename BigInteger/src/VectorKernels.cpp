@@ -0,0 +1,189 @@
+#include "LimbArithmetic.h"
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+
+// AVX2 versions of the limb loops. A block of lanes is added (or
+// subtracted) at once, and the carries between lanes are resolved with
+// one scalar addition of lane bitmasks: lanes that generate a carry are
+// shifted up by one and added to the lanes that would propagate one, so
+// the bits that flip are exactly the lanes receiving a carry.
+namespace {
+#ifdef BIGINTEGER_BINARY_LIMBS
+  const size_t kLanes = 4;
+  const unsigned kLaneMask = 0xF;
+
+  __attribute__((target("avx2"))) unsigned laneMask(__m256i mask) {
+    return _mm256_movemask_pd(_mm256_castsi256_pd(mask));
+  }
+
+  // Lane i gets 1 when bit i of carries is set.
+  __attribute__((target("avx2"))) __m256i carryLanes(unsigned carries) {
+    return _mm256_and_si256(
+        _mm256_srlv_epi64(_mm256_set1_epi64x(carries),
+                          _mm256_setr_epi64x(0, 1, 2, 3)),
+        _mm256_set1_epi64x(1));
+  }
+
+  __attribute__((target("avx2"))) __m256i lessUnsigned(__m256i num1,
+                                                       __m256i num2) {
+    __m256i sign = _mm256_set1_epi64x(INT64_MIN);
+    return _mm256_cmpgt_epi64(_mm256_xor_si256(num2, sign),
+                              _mm256_xor_si256(num1, sign));
+  }
+#else
+  const size_t kLanes = 8;
+  const unsigned kLaneMask = 0xFF;
+
+  __attribute__((target("avx2"))) unsigned laneMask(__m256i mask) {
+    return _mm256_movemask_ps(_mm256_castsi256_ps(mask));
+  }
+
+  __attribute__((target("avx2"))) __m256i carryLanes(unsigned carries) {
+    return _mm256_and_si256(
+        _mm256_srlv_epi32(_mm256_set1_epi32(carries),
+                          _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)),
+        _mm256_set1_epi32(1));
+  }
+#endif
+
+  // Returns the lanes that receive a carry and updates carry to the one
+  // leaving the block.
+  unsigned resolveCarries(unsigned generate, unsigned propagate,
+                          unsigned& carry) {
+    unsigned sum = ((generate << 1) | carry) + propagate;
+    carry = sum >> kLanes;
+    return (sum ^ propagate) & kLaneMask;
+  }
+}
+
+bool BigInteger::hasVectorKernels() {
+    static const bool kHasAvx2 = __builtin_cpu_supports("avx2");
+    return kHasAvx2;
+}
+
+__attribute__((target("avx2"))) BigInteger::Limb BigInteger::addLimbsVector(
+    Limb* dst, const Limb* src, size_t len, Limb carry) {
+    unsigned block_carry = carry;
+    size_t i = 0;
+    for (; i + kLanes <= len; i += kLanes) {
+        __m256i num1 = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i num2 = _mm256_loadu_si256((const __m256i*)(src + i));
+#ifdef BIGINTEGER_BINARY_LIMBS
+        __m256i sum = _mm256_add_epi64(num1, num2);
+        unsigned carries = resolveCarries(
+            laneMask(lessUnsigned(sum, num1)),
+            laneMask(_mm256_cmpeq_epi64(sum, _mm256_set1_epi64x(-1))),
+            block_carry);
+        sum = _mm256_add_epi64(sum, carryLanes(carries));
+#else
+        __m256i top = _mm256_set1_epi32(kBIBase_ - 1);
+        __m256i sum = _mm256_add_epi32(num1, num2);
+        unsigned carries = resolveCarries(
+            laneMask(_mm256_cmpgt_epi32(sum, top)),
+            laneMask(_mm256_cmpeq_epi32(sum, top)), block_carry);
+        sum = _mm256_add_epi32(sum, carryLanes(carries));
+        __m256i overflow = _mm256_cmpgt_epi32(sum, top);
+        sum = _mm256_sub_epi32(
+            sum, _mm256_and_si256(overflow, _mm256_set1_epi32(kBIBase_)));
+#endif
+        _mm256_storeu_si256((__m256i*)(dst + i), sum);
+    }
+    carry = block_carry;
+    for (; i < len; ++i) {
+        dst[i] = addWithCarry(dst[i], src[i], carry);
+    }
+    return carry;
+}
+
+// dst = num1 - num2 - loan over len limbs; dst may alias either operand.
+__attribute__((target("avx2"))) BigInteger::Limb
+BigInteger::subtractLimbsVector(Limb* dst, const Limb* num1,
+                                const Limb* num2, size_t len, Limb loan) {
+    unsigned block_loan = loan;
+    size_t i = 0;
+    for (; i + kLanes <= len; i += kLanes) {
+        __m256i first = _mm256_loadu_si256((const __m256i*)(num1 + i));
+        __m256i second = _mm256_loadu_si256((const __m256i*)(num2 + i));
+#ifdef BIGINTEGER_BINARY_LIMBS
+        __m256i difference = _mm256_sub_epi64(first, second);
+        unsigned loans = resolveCarries(
+            laneMask(lessUnsigned(first, second)),
+            laneMask(_mm256_cmpeq_epi64(first, second)), block_loan);
+        difference = _mm256_sub_epi64(difference, carryLanes(loans));
+#else
+        __m256i zero = _mm256_setzero_si256();
+        __m256i difference = _mm256_sub_epi32(first, second);
+        unsigned loans = resolveCarries(
+            laneMask(_mm256_cmpgt_epi32(zero, difference)),
+            laneMask(_mm256_cmpeq_epi32(difference, zero)), block_loan);
+        difference = _mm256_sub_epi32(difference, carryLanes(loans));
+        __m256i negative = _mm256_cmpgt_epi32(zero, difference);
+        difference = _mm256_add_epi32(
+            difference,
+            _mm256_and_si256(negative, _mm256_set1_epi32(kBIBase_)));
+#endif
+        _mm256_storeu_si256((__m256i*)(dst + i), difference);
+    }
+    loan = block_loan;
+    for (; i < len; ++i) {
+        dst[i] = subtractWithLoan(num1[i], num2[i], loan);
+    }
+    return loan;
+}
+
+// Compares two len-limb magnitudes from the top, a block at a time.
+__attribute__((target("avx2"))) int BigInteger::compareLimbsVector(
+    const Limb* num1, const Limb* num2, size_t len) {
+    size_t end = len;
+    for (; end >= kLanes; end -= kLanes) {
+        size_t start = end - kLanes;
+        __m256i first = _mm256_loadu_si256((const __m256i*)(num1 + start));
+        __m256i second = _mm256_loadu_si256((const __m256i*)(num2 + start));
+#ifdef BIGINTEGER_BINARY_LIMBS
+        unsigned equal = laneMask(_mm256_cmpeq_epi64(first, second));
+#else
+        unsigned equal = laneMask(_mm256_cmpeq_epi32(first, second));
+#endif
+        if (equal != kLaneMask) {
+            size_t i = start + 31 - __builtin_clz(~equal & kLaneMask);
+            return num1[i] < num2[i] ? -1 : 1;
+        }
+    }
+    for (; end > 0; --end) {
+        if (num1[end - 1] != num2[end - 1]) {
+            return num1[end - 1] < num2[end - 1] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+#else
+bool BigInteger::hasVectorKernels() { return false; }
+
+BigInteger::Limb BigInteger::addLimbsVector(Limb* dst, const Limb* src,
+                                            size_t len, Limb carry) {
+    for (size_t i = 0; i < len; ++i) {
+        dst[i] = addWithCarry(dst[i], src[i], carry);
+    }
+    return carry;
+}
+
+BigInteger::Limb BigInteger::subtractLimbsVector(Limb* dst, const Limb* num1,
+                                                 const Limb* num2, size_t len,
+                                                 Limb loan) {
+    for (size_t i = 0; i < len; ++i) {
+        dst[i] = subtractWithLoan(num1[i], num2[i], loan);
+    }
+    return loan;
+}
+
+int BigInteger::compareLimbsVector(const Limb* num1, const Limb* num2,
+                                   size_t len) {
+    for (size_t i = len; i > 0; --i) {
+        if (num1[i - 1] != num2[i - 1]) {
+            return num1[i - 1] < num2[i - 1] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+#endif